@@ -4,13 +4,17 @@
 
 // JSONL utilities for this project:
 // - JSON escaping
+// - line_buffer for encoding events without iostreams
 // - unix time helpers
 // - jsonl_context for emitting JSONL events (meta/event/eof) to a stream
 
 #pragma once
 
 #include <algorithm>
+#include <charconv>
+#include <concepts>
 #include <cstddef>
+#include <iterator>
 #include <string>
 #include <string_view>
 #include <format>
@@ -19,8 +23,8 @@
 #include <ostream>
 #include <random>
 #include <ranges>
-#include <sstream>
 #include <type_traits>
+#include <utility>
 #include <unistd.h>
 
 namespace jsonl {
@@ -69,59 +73,94 @@ inline bool needs_json_escape(std::string_view sv)
     });
 }
 
-// Stream a JSON string body (no surrounding quotes). Prefer this when the sink is
-// already an ostream — `escape` materializes a temporary for the same work.
-inline void escape_to(std::ostream& os, std::string_view sv)
+// The escaping itself, for any sink that can take a run of bytes. `write` is called with
+// string_views: unescaped runs go out whole rather than a byte at a time, which is most of the
+// work for the mostly-clean text tests produce.
+template<typename Write>
+void escape_with(std::string_view sv, Write&& write)
 {
     if(not needs_json_escape(sv))
     {
-        os.write(sv.data(), static_cast<std::streamsize>(sv.size()));
+        write(sv);
         return;
     }
 
-    constexpr auto replacement_character = "\xef\xbf\xbd";
+    constexpr auto replacement_character = std::string_view{"\xef\xbf\xbd"};
+
+    auto clean_from = std::size_t{0};
+    auto flush_clean = [&](std::size_t until)
+    {
+        if(until > clean_from)
+            write(sv.substr(clean_from, until - clean_from));
+    };
 
     for(std::size_t index = 0; index < sv.size();)
     {
         const auto ch = static_cast<unsigned char>(sv[index]);
+        auto replacement = std::string_view{};
         switch(ch)
         {
-            case '\\': os << "\\\\"; ++index; continue;
-            case '"':  os << "\\\""; ++index; continue;
-            case '\b': os << "\\b"; ++index; continue;
-            case '\f': os << "\\f"; ++index; continue;
-            case '\n': os << "\\n"; ++index; continue;
-            case '\r': os << "\\r"; ++index; continue;
-            case '\t': os << "\\t"; ++index; continue;
+            case '\\': replacement = "\\\\"; break;
+            case '"':  replacement = "\\\""; break;
+            case '\b': replacement = "\\b"; break;
+            case '\f': replacement = "\\f"; break;
+            case '\n': replacement = "\\n"; break;
+            case '\r': replacement = "\\r"; break;
+            case '\t': replacement = "\\t"; break;
             default: break;
         }
 
+        if(not replacement.empty())
+        {
+            flush_clean(index);
+            write(replacement);
+            clean_from = ++index;
+            continue;
+        }
+
         if(ch < 0x20)
         {
-            os << std::format("\\u{:04x}", static_cast<unsigned int>(ch));
-            ++index;
+            flush_clean(index);
+            char digits[8]{};
+            const auto end = std::format_to_n(digits, sizeof digits, "\\u{:04x}", static_cast<unsigned int>(ch)).out;
+            write(std::string_view{digits, static_cast<std::size_t>(end - digits)});
+            clean_from = ++index;
             continue;
         }
 
         if(ch < 0x80)
         {
-            os.put(static_cast<char>(ch));
             ++index;
             continue;
         }
 
         if(const auto length = utf8_sequence_length(sv, index); length > 0)
         {
-            os.write(sv.data() + static_cast<std::ptrdiff_t>(index),
-                     static_cast<std::streamsize>(length));
             index += length;
             continue;
         }
 
         // Invalid byte: emit one replacement character and resynchronise by one byte.
-        os << replacement_character;
-        ++index;
+        flush_clean(index);
+        write(replacement_character);
+        clean_from = ++index;
     }
+    flush_clean(sv.size());
+}
+
+// Stream a JSON string body (no surrounding quotes). Prefer this when the sink is
+// already an ostream — `escape` materializes a temporary for the same work.
+inline void escape_to(std::ostream& os, std::string_view sv)
+{
+    escape_with(sv, [&](std::string_view run) {
+        os.write(run.data(), static_cast<std::streamsize>(run.size()));
+    });
+}
+
+// Append a JSON string body to `out`, which is how a line_buffer escapes.
+inline void escape_append(std::string& out, std::string_view sv)
+{
+    escape_with(sv, [&](std::string_view run) { out.append(run); });
 }
 
 // JSON requires valid UTF-8. Test data is arbitrary bytes, so invalid sequences are
@@ -133,11 +172,86 @@ inline std::string escape(std::string_view sv)
     if(not needs_json_escape(sv))
         return std::string{sv};
 
-    auto out = std::ostringstream{};
-    escape_to(out, sv);
-    return std::move(out).str();
+    auto out = std::string{};
+    out.reserve(sv.size() + sv.size() / 8);
+    escape_append(out, sv);
+    return out;
+}
+
+// `os << escaped{text}` writes the escaped body straight into whatever `os` is, where
+// `os << escape(text)` builds a string first only to copy it.
+struct escaped
+{
+    std::string_view text;
+};
+
+inline std::ostream& operator<<(std::ostream& os, escaped value)
+{
+    escape_to(os, value.text);
+    return os;
 }
 
+// One or more JSONL lines under construction, written the way an observer writes to an
+// ostream. Text is appended to a std::string and numbers go through to_chars, so a field costs
+// an append: no sentry, no locale and no virtual call per `<<`, which is what an event spent
+// most of its time on. Doubles have no `<<` — their precision is part of the schema, so a
+// caller says it with format().
+class line_buffer
+{
+public:
+    line_buffer& operator<<(std::string_view text)
+    {
+        m_text.append(text);
+        return *this;
+    }
+
+    line_buffer& operator<<(const char* text) { return *this << std::string_view{text}; }
+
+    line_buffer& operator<<(char ch)
+    {
+        m_text.push_back(ch);
+        return *this;
+    }
+
+    line_buffer& operator<<(escaped value)
+    {
+        escape_append(m_text, value.text);
+        return *this;
+    }
+
+    template<std::integral Integer>
+        requires (not std::same_as<Integer, bool> and not std::same_as<Integer, char>)
+    line_buffer& operator<<(Integer value)
+    {
+        char digits[24];
+        const auto [end, error] = std::to_chars(std::begin(digits), std::end(digits), value);
+        m_text.append(digits, static_cast<std::size_t>(end - digits));
+        return *this;
+    }
+
+    // A bool would otherwise convert to char and write a control byte; JSON wants a word.
+    line_buffer& operator<<(bool) = delete;
+
+    template<typename... Args>
+    line_buffer& format(std::format_string<Args...> fmt, Args&&... args)
+    {
+        std::format_to(std::back_inserter(m_text), fmt, std::forward<Args>(args)...);
+        return *this;
+    }
+
+    [[nodiscard]] std::string_view view() const { return m_text; }
+    [[nodiscard]] std::size_t size() const { return m_text.size(); }
+    [[nodiscard]] bool empty() const { return m_text.empty(); }
+    void clear() { m_text.clear(); }
+    void reserve(std::size_t bytes) { m_text.reserve(bytes); }
+
+    // Hands the text over whole, leaving the buffer empty.
+    [[nodiscard]] std::string take() { return std::exchange(m_text, {}); }
+
+private:
+    std::string m_text{};
+};
+
 inline std::chrono::milliseconds unix_ms_now()
 {
     using namespace std::chrono;
@@ -169,9 +283,9 @@ template<typename Stream>
 inline void write_run_ids(Stream& os, std::string_view run_id, std::string_view parent_run_id)
 {
     if(!run_id.empty())
-        os << ",\"run_id\":\"" << escape(run_id) << "\"";
+        os << ",\"run_id\":\"" << escaped{run_id} << "\"";
     if(!parent_run_id.empty())
-        os << ",\"parent_run_id\":\"" << escape(parent_run_id) << "\"";
+        os << ",\"parent_run_id\":\"" << escaped{parent_run_id} << "\"";
 }
 
 template<typename Stream, typename F>
@@ -265,6 +379,21 @@ struct jsonl_context
         parent_run_id.assign(id);
     }
 
+    // The same lines as emit_meta/emit_event, appended to `out` instead of written to the
+    // stream. For a sink that decides itself when bytes reach the stream — the tester's
+    // buffered writer — and so also owns the meta-first and eof-last ordering.
+    template<typename Buffer>
+    void encode_meta(Buffer& out) const
+    {
+        emit_event_raw(out, "meta", schema, version, unix_ms_now(), pid(), run_id, parent_run_id, [](auto&){});
+    }
+
+    template<typename Buffer, typename F>
+    void encode_event(Buffer& out, std::string_view type, std::chrono::milliseconds ts, F&& add_fields) const
+    {
+        emit_event_raw(out, type, schema, version, ts, pid(), run_id, parent_run_id, std::forward<F>(add_fields));
+    }
+
     void emit_meta()
     {
         if(!enabled || meta_printed) return;
@@ -6,7 +6,12 @@
 #pragma clang diagnostic ignored "-Wincomplete-umbrella"
 #include <csignal>
 #pragma clang diagnostic pop
+#include <errno.h>
 #include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 import std;
@@ -14,6 +19,9 @@ import tester;
 
 using namespace std::literals;
 
+// Process environment for posix_spawn, which --processes children inherit.
+extern char** environ;
+
 namespace {
 
 auto append_cstr(char* buffer, std::size_t size, std::size_t capacity, const char* text)
@@ -39,6 +47,24 @@ auto append_unsigned(char* buffer, std::size_t size, std::size_t capacity, unsig
     return size;
 }
 
+// JSON string body for a test id, without allocating: quotes and backslashes are escaped and
+// control characters dropped, which is all an id can carry that would break the line.
+auto append_json_text(char* buffer, std::size_t size, std::size_t capacity, std::string_view text)
+{
+    for(const char ch : text)
+    {
+        if(static_cast<unsigned char>(ch) < 0x20)
+            continue;
+        const auto escaped = ch == '"' || ch == '\\';
+        if(size + (escaped ? 2 : 1) > capacity)
+            break;
+        if(escaped)
+            buffer[size++] = '\\';
+        buffer[size++] = ch;
+    }
+    return size;
+}
+
 void emit_crash_event(
     int stdout_fd,
     int stderr_fd,
@@ -46,9 +72,10 @@ void emit_crash_event(
     const char* schema,
     std::size_t schema_length,
     int version,
+    std::string_view test_id,
     bool emit_result_line)
 {
-    auto buffer = std::array<char, 256>{};
+    auto buffer = std::array<char, 1024>{};
     auto size = std::size_t{};
 
     size = append_cstr(buffer.data(), size, buffer.size(), "{\"type\":\"crash\",\"schema\":\"");
@@ -60,6 +87,14 @@ void emit_crash_event(
     size = append_unsigned(buffer.data(), size, buffer.size(), static_cast<unsigned>(::getpid()));
     size = append_cstr(buffer.data(), size, buffer.size(), ",\"signal\":");
     size = append_unsigned(buffer.data(), size, buffer.size(), signal_number);
+    // The case the crashing thread was running, so a reader — or a --processes parent — can
+    // fail that case rather than the whole run. Bounded so the closing brace always fits.
+    if(not test_id.empty())
+    {
+        size = append_cstr(buffer.data(), size, buffer.size() - 8, ",\"test_id\":\"");
+        size = append_json_text(buffer.data(), size, buffer.size() - 8, test_id);
+        size = append_cstr(buffer.data(), size, buffer.size(), "\"");
+    }
     size = append_cstr(buffer.data(), size, buffer.size(), "}\n");
 
     (void)::write(stdout_fd, buffer.data(), size);
@@ -71,8 +106,741 @@ void emit_crash_event(
     }
 }
 
+// Top-level fields of one JSONL line from a child runner, as raw JSON: strings keep their quotes,
+// arrays and objects come back whole. The line came from our own writer, so this only has to step
+// over strings and nesting correctly — it is not a validating parser.
+class child_event
+{
+public:
+    explicit child_event(std::string_view line)
+    {
+        auto at = line.find('{');
+        if(at == std::string_view::npos)
+            return;
+        ++at;
+        while(at < line.size())
+        {
+            at = line.find_first_of("\"}", at);
+            if(at == std::string_view::npos or line[at] == '}')
+                return;
+            const auto key_end = skip_string(line, at);
+            const auto key = line.substr(at + 1, key_end - at - 2);
+            at = line.find(':', key_end);
+            if(at == std::string_view::npos)
+                return;
+
+            const auto value_start = ++at;
+            for(auto depth = 0; at < line.size(); ++at)
+            {
+                const auto ch = line[at];
+                if(ch == '"')
+                    at = skip_string(line, at) - 1;
+                else if(ch == '[' or ch == '{')
+                    ++depth;
+                else if((ch == ']' or ch == '}' or ch == ',') and depth == 0)
+                    break;
+                else if(ch == ']' or ch == '}')
+                    --depth;
+            }
+            m_fields.emplace_back(key, line.substr(value_start, at - value_start));
+            if(at < line.size() and line[at] == ',')
+                ++at;
+        }
+    }
+
+    std::string text(std::string_view key) const
+    {
+        return decode(raw(key));
+    }
+
+    std::size_t number(std::string_view key) const
+    {
+        const auto value = raw(key);
+        auto parsed = std::size_t{};
+        std::from_chars(value.data(), value.data() + value.size(), parsed);
+        return parsed;
+    }
+
+    double real(std::string_view key) const
+    {
+        const auto value = raw(key);
+        auto parsed = 0.0;
+        std::from_chars(value.data(), value.data() + value.size(), parsed);
+        return parsed;
+    }
+
+    bool boolean(std::string_view key) const
+    {
+        return raw(key) == "true";
+    }
+
+    bool has(std::string_view key) const
+    {
+        return not raw(key).empty();
+    }
+
+private:
+    std::vector<std::pair<std::string_view, std::string_view>> m_fields;
+
+    std::string_view raw(std::string_view key) const
+    {
+        const auto found = std::ranges::find(m_fields, key, &std::pair<std::string_view, std::string_view>::first);
+        return found != m_fields.end() ? found->second : std::string_view{};
+    }
+
+    // Index just past the string that opens at `at`.
+    static std::size_t skip_string(std::string_view line, std::size_t at)
+    {
+        for(++at; at < line.size() and line[at] != '"'; ++at)
+        {
+            if(line[at] == '\\')
+                ++at;
+        }
+        return std::min(at + 1, line.size());
+    }
+
+    // The escapes jsonl::escape_to writes: the short forms, and \u00XX for other control bytes.
+    static std::string decode(std::string_view value)
+    {
+        auto out = std::string{};
+        if(value.size() < 2 or value.front() != '"')
+            return out;
+        value = value.substr(1, value.size() - 2);
+        out.reserve(value.size());
+        for(auto at = std::size_t{0}; at < value.size(); ++at)
+        {
+            if(value[at] != '\\' or at + 1 == value.size())
+            {
+                out.push_back(value[at]);
+                continue;
+            }
+            switch(const auto escape = value[++at]; escape)
+            {
+                case 'n': out.push_back('\n'); break;
+                case 't': out.push_back('\t'); break;
+                case 'r': out.push_back('\r'); break;
+                case 'b': out.push_back('\b'); break;
+                case 'f': out.push_back('\f'); break;
+                case 'u':
+                {
+                    auto code = 0u;
+                    const auto digits = value.substr(at + 1, 4);
+                    std::from_chars(digits.data(), digits.data() + digits.size(), code, 16);
+                    at += digits.size();
+                    if(code < 0x80)
+                        out.push_back(static_cast<char>(code));
+                    else if(code < 0x800)
+                    {
+                        out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+                        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+                    }
+                    else
+                    {
+                        out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+                        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+                    }
+                    break;
+                }
+                default: out.push_back(escape); break;
+            }
+        }
+        return out;
+    }
+};
+
+// test_runner --processes=N. The catalogue's dependency groups form a queue, and N child runners
+// take batches from it: each child is this program, handed the ids of its batch on stdin
+// (--ids-from=-), reporting JSONL that the parent reads back into results. The parent's sinks,
+// summary, run_end and exit status are therefore those of a single run.
+//
+// A child that dies takes only its batch with it. The crash event names the case it was in, and
+// that case becomes a failed result; the rest of the batch goes back on the queue. Without a
+// name, the batch is split into its groups and each is retried on its own, so a crash is pinned
+// to one group at worst.
+class process_pool
+{
+public:
+    struct settings
+    {
+        std::size_t processes = 1;
+        std::string program{};
+        // Every child gets these, ahead of nothing else: --jsonl=<mode> --ids-from=- and the
+        // filters and limits the parent was given.
+        std::vector<std::string> arguments{};
+        std::string parent_run_id{};
+        // Which child lines the parent's own JSONL stream keeps; none when it is the console.
+        std::optional<tester::output::jsonl::jsonl_mode> forward{};
+    };
+
+    process_pool(settings config, std::vector<std::vector<tester::data::test_metadata>> groups)
+        : m_settings{std::move(config)}
+        , m_groups{std::move(groups)}
+    {
+        for(auto order = std::size_t{0}; order < m_groups.size(); ++order)
+        {
+            auto ids = std::vector<std::string>{};
+            for(const auto& metadata : m_groups[order])
+            {
+                m_known.try_emplace(metadata.test_id, &metadata, order);
+                ids.push_back(metadata.test_id);
+            }
+            m_pending.push_back(work{order, std::move(ids), false});
+        }
+
+        constexpr auto parent_key = "TESTER_PARENT_RUN_ID="sv;
+        for(auto** entry = environ; entry != nullptr and *entry != nullptr; ++entry)
+        {
+            if(not std::string_view{*entry}.starts_with(parent_key))
+                m_environment.emplace_back(*entry);
+        }
+        if(not m_settings.parent_run_id.empty())
+            m_environment.push_back(std::string{parent_key} + m_settings.parent_run_id);
+    }
+
+    void run(tester::data::execution_context& execution)
+    {
+        auto children = std::list<child>{};
+        while(not m_pending.empty() or not children.empty())
+        {
+            while(children.size() < m_settings.processes and not m_pending.empty())
+                spawn(children.emplace_back(), take_batch());
+            read_available(children);
+
+            for(auto it = children.begin(); it != children.end();)
+            {
+                if(it->out < 0 and it->err < 0)
+                {
+                    finish(*it, execution.statistics);
+                    it = children.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+        std::cout << std::flush;
+
+        for(auto& [order, result] : m_results)
+            execution.results.push_back(std::move(result));
+    }
+
+private:
+    struct work
+    {
+        std::size_t order = 0;
+        std::vector<std::string> ids{};
+        // Retried by itself: it was in a batch whose child died without naming a case.
+        bool alone = false;
+    };
+
+    struct child
+    {
+        pid_t pid = -1;
+        int out = -1;
+        int err = -1;
+        std::vector<work> batch{};
+        std::string out_partial{};
+        std::string err_partial{};
+        std::string err_tail{};
+        // Forwarded once the batch has an outcome, so a batch that is retried is not reported twice.
+        std::vector<std::string> held{};
+        std::vector<std::pair<std::size_t, tester::data::test_result>> results{};
+        std::optional<std::array<std::size_t, 4>> summary{};
+        std::string crashed_in{};
+        std::string crash_line{};
+    };
+
+    struct known_case
+    {
+        const tester::data::test_metadata* metadata = nullptr;
+        std::size_t order = 0;
+    };
+
+    settings m_settings;
+    std::vector<std::vector<tester::data::test_metadata>> m_groups;
+    std::map<std::string_view, known_case, std::less<>> m_known{};
+    std::deque<work> m_pending{};
+    std::vector<std::string> m_environment{};
+    // Catalogue order, not completion order: a report reads the same however the batches fell.
+    std::multimap<std::size_t, tester::data::test_result> m_results{};
+    // Backs the file names of cases the parent never saw — a case registered inside another.
+    std::deque<std::string> m_file_names{};
+
+    // Large batches while the queue is long, single groups at the end, so the last children
+    // finish together instead of one draining a big batch alone.
+    std::vector<work> take_batch()
+    {
+        auto batch = std::vector<work>{};
+        const auto size = std::max<std::size_t>(1, m_pending.size() / (m_settings.processes * 4));
+        while(not m_pending.empty() and batch.size() < size)
+        {
+            if(m_pending.front().alone and not batch.empty())
+                break;
+            batch.push_back(std::move(m_pending.front()));
+            m_pending.pop_front();
+            if(batch.back().alone)
+                break;
+        }
+        return batch;
+    }
+
+    void spawn(child& target, std::vector<work> batch)
+    {
+        target.batch = std::move(batch);
+
+        int in[2], out[2], err[2];
+        if(::pipe(in) != 0 or ::pipe(out) != 0 or ::pipe(err) != 0)
+            throw std::system_error{errno, std::generic_category(), "pipe"};
+        // Close-on-exec everywhere: a child inherits its own three ends through dup2, and none of
+        // its siblings'. A sibling holding a write end open would keep this child's EOF away.
+        for(const auto fd : {in[0], in[1], out[0], out[1], err[0], err[1]})
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+        auto actions = posix_spawn_file_actions_t{};
+        ::posix_spawn_file_actions_init(&actions);
+        ::posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+        ::posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+        ::posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+
+        auto argv = std::vector<char*>{};
+        argv.push_back(m_settings.program.data());
+        for(auto& argument : m_settings.arguments)
+            argv.push_back(argument.data());
+        argv.push_back(nullptr);
+        auto envp = std::vector<char*>{};
+        for(auto& entry : m_environment)
+            envp.push_back(entry.data());
+        envp.push_back(nullptr);
+
+        const auto spawned = ::posix_spawnp(&target.pid, m_settings.program.c_str(), &actions, nullptr, argv.data(), envp.data());
+        ::posix_spawn_file_actions_destroy(&actions);
+        ::close(in[0]);
+        ::close(out[1]);
+        ::close(err[1]);
+        target.out = out[0];
+        target.err = err[0];
+        if(spawned != 0)
+        {
+            ::close(in[1]);
+            throw std::system_error{spawned, std::generic_category(), "posix_spawn " + m_settings.program};
+        }
+
+        auto ids = std::string{};
+        for(const auto& item : target.batch)
+            for(const auto& id : item.ids)
+                ids.append(id).push_back('\n');
+        // A child that dies before reading its ids closes the pipe; SIGPIPE is ignored while the
+        // pool runs, so that is EPIPE here and the missing summary is handled like any crash.
+        for(auto written = std::size_t{0}; written < ids.size();)
+        {
+            const auto n = ::write(in[1], ids.data() + written, ids.size() - written);
+            if(n < 0 and errno == EINTR)
+                continue;
+            if(n <= 0)
+                break;
+            written += static_cast<std::size_t>(n);
+        }
+        ::close(in[1]);
+    }
+
+    void read_available(std::list<child>& children)
+    {
+        auto fds = std::vector<pollfd>{};
+        auto owners = std::vector<std::pair<child*, bool>>{};
+        for(auto& target : children)
+        {
+            if(target.out >= 0)
+            {
+                fds.push_back(pollfd{target.out, POLLIN, 0});
+                owners.emplace_back(&target, false);
+            }
+            if(target.err >= 0)
+            {
+                fds.push_back(pollfd{target.err, POLLIN, 0});
+                owners.emplace_back(&target, true);
+            }
+        }
+        if(fds.empty())
+            return;
+
+        if(::poll(fds.data(), static_cast<nfds_t>(fds.size()), -1) < 0)
+        {
+            if(errno == EINTR)
+                return;
+            throw std::system_error{errno, std::generic_category(), "poll"};
+        }
+
+        auto buffer = std::array<char, 65536>{};
+        for(auto i = std::size_t{0}; i < fds.size(); ++i)
+        {
+            if(fds[i].revents == 0)
+                continue;
+            auto& [target, is_err] = owners[i];
+            const auto n = ::read(fds[i].fd, buffer.data(), buffer.size());
+            if(n < 0 and errno == EINTR)
+                continue;
+            if(n <= 0)
+            {
+                ::close(fds[i].fd);
+                (is_err ? target->err : target->out) = -1;
+                // A line cut off by the child's death is still a line.
+                consume(*target, is_err, "\n");
+                continue;
+            }
+            consume(*target, is_err, std::string_view{buffer.data(), static_cast<std::size_t>(n)});
+        }
+    }
+
+    void consume(child& target, bool is_err, std::string_view bytes)
+    {
+        auto& partial = is_err ? target.err_partial : target.out_partial;
+        partial += bytes;
+        auto start = std::size_t{0};
+        for(auto eol = partial.find('\n'); eol != std::string::npos; eol = partial.find('\n', start))
+        {
+            const auto line = std::string_view{partial}.substr(start, eol - start);
+            if(not line.empty())
+                is_err ? child_diagnostic(target, line) : child_line(target, line);
+            start = eol + 1;
+        }
+        partial.erase(0, start);
+    }
+
+    // The child's own RESULT line would contradict the parent's; anything else a test printed
+    // goes where it would have gone in-process. The tail is kept for a crash report.
+    static void child_diagnostic(child& target, std::string_view line)
+    {
+        if(line.starts_with("RESULT:"))
+            return;
+        std::clog << line << '\n';
+        target.err_tail.append(line).push_back('\n');
+        if(constexpr auto keep = std::size_t{8192}; target.err_tail.size() > keep)
+            target.err_tail.erase(0, target.err_tail.size() - keep);
+    }
+
+    void child_line(child& target, std::string_view line)
+    {
+        const auto event = child_event{line};
+        const auto type = event.text("type");
+        if(type == "test")
+            target.results.push_back(result_from(target, event));
+        else if(type == "summary")
+            target.summary = std::array{
+                event.number("tests_ok"), event.number("tests_total"),
+                event.number("assertions_ok"), event.number("assertions_total")};
+        else if(type == "benchmark_result")
+            benchmark_from(target, event);
+        else if(type == "crash")
+        {
+            target.crashed_in = event.text("test_id");
+            target.crash_line = line;
+        }
+        else if(forwarded(type, event))
+            target.held.emplace_back(line);
+    }
+
+    // The parent's stream keeps what its own mode would have written in-process. The envelope
+    // stays the child's — its pid and run_id, with this run as parent_run_id.
+    bool forwarded(std::string_view type, const child_event& event) const
+    {
+        using tester::output::jsonl::jsonl_mode;
+        if(not m_settings.forward.has_value() or *m_settings.forward == jsonl_mode::summary)
+            return false;
+        if(*m_settings.forward == jsonl_mode::trace)
+            return type == "case" or type == "assertion_passed" or type == "assertion_failed"
+                or type == "message" or type == "exception";
+        return type == "assertion_failed" or type == "exception"
+            or (type == "message" and not event.boolean("ok"));
+    }
+
+    std::pair<std::size_t, tester::data::test_result> result_from(const child& target, const child_event& event)
+    {
+        const auto id = event.text("id");
+        auto result = [&]
+        {
+            if(const auto found = m_known.find(id); found != m_known.end())
+                return tester::data::test_result{*found->second.metadata};
+            const auto& file = m_file_names.emplace_back(event.text("file"));
+            return tester::data::test_result{tester::data::test_metadata{
+                .test_set_name = event.text("set"),
+                .test_name = event.text("name"),
+                .file_name = file,
+                .line = static_cast<std::uint_least32_t>(event.number("line")),
+                .column = static_cast<std::uint_least32_t>(event.number("column")),
+                .function_name = {},
+                .test_id = id}};
+        }();
+        result.success = event.boolean("success");
+        result.output = event.text("output");
+        result.duration = std::chrono::milliseconds{event.number("duration_ms")};
+        result.assertions_ok = event.number("assertions_ok");
+        result.assertions_total = event.number("assertions_total");
+        result.started_at = std::chrono::system_clock::time_point{std::chrono::milliseconds{event.number("started_unix_ms")}};
+        result.finished_at = std::chrono::system_clock::time_point{std::chrono::milliseconds{event.number("finished_unix_ms")}};
+        if(event.has("cpu_ns"))
+        {
+            auto& usage = result.resources.emplace();
+            usage.cpu_time = std::chrono::nanoseconds{event.number("cpu_ns")};
+            if(event.has("allocations"))
+                usage.allocations = tester::data::allocation_counts{
+                    .count = event.number("allocations"),
+                    .bytes = event.number("allocated_bytes")};
+            if(event.has("peak_rss_growth_bytes"))
+                usage.peak_rss_growth_bytes = event.number("peak_rss_growth_bytes");
+        }
+        return {order_of(target, id), std::move(result)};
+    }
+
+    // Follows its case's test line when there is one. Outside trace a passing case has none, and
+    // the measurement still needs a result to hang on, so it gets a passing one of its own.
+    void benchmark_from(child& target, const child_event& event)
+    {
+        const auto id = event.text("id");
+        auto found = std::ranges::find(target.results, id, [](const auto& entry) -> const std::string& {
+            return entry.second.test_id;
+        });
+        if(found == target.results.end())
+        {
+            target.results.push_back(result_from(target, event));
+            found = std::prev(target.results.end());
+            found->second.success = true;
+        }
+
+        auto& measured = found->second.benchmark.emplace();
+        measured.iterations = event.number("iterations");
+        measured.samples = event.number("samples");
+        measured.mean_ns = event.real("mean_ns");
+        measured.median_ns = event.real("median_ns");
+        measured.stddev_ns = event.real("stddev_ns");
+        measured.min_ns = event.real("min_ns");
+        measured.items_per_second = event.real("items_per_second");
+        measured.bytes_per_second = event.real("bytes_per_second");
+        measured.baseline_median_ns = event.real("baseline_median_ns");
+        measured.regressed = event.boolean("regressed");
+    }
+
+    std::size_t order_of(const child& target, std::string_view id) const
+    {
+        if(const auto found = m_known.find(id); found != m_known.end())
+            return found->second.order;
+        return target.batch.front().order;
+    }
+
+    void forward(std::string_view line) const
+    {
+        std::cout << line << '\n';
+    }
+
+    void finish(child& target, tester::data::test_statistics& statistics)
+    {
+        auto status = 0;
+        while(::waitpid(target.pid, &status, 0) < 0 and errno == EINTR)
+        {}
+
+        if(target.summary.has_value())
+        {
+            const auto& [tests_ok, tests_total, assertions_ok, assertions_total] = *target.summary;
+            statistics.successful_tests.fetch_add(tests_ok, std::memory_order_relaxed);
+            statistics.total_tests.fetch_add(tests_total, std::memory_order_relaxed);
+            statistics.successful_assertions.fetch_add(assertions_ok, std::memory_order_relaxed);
+            statistics.total_assertions.fetch_add(assertions_total, std::memory_order_relaxed);
+            for(auto& [order, result] : target.results)
+                m_results.emplace(order, std::move(result));
+            for(const auto& line : target.held)
+                forward(line);
+            return;
+        }
+
+        const auto ended = WIFSIGNALED(status)
+            ? std::format("signal {}", WTERMSIG(status))
+            : std::format("exit code {} and no summary", WEXITSTATUS(status));
+
+        // What the child finished before it died stays finished: a child writes each case's test
+        // line as the case ends, so those results are whole. Only the cases it never reached go
+        // back on the queue — running a case twice is what --processes exists to avoid.
+        const auto finished = keep_finished(target, statistics);
+        for(auto& item : target.batch)
+            std::erase_if(item.ids, [&](const std::string& id){ return finished.contains(id); });
+        std::erase_if(target.batch, [](const work& item){ return item.ids.empty(); });
+
+        const auto named = std::ranges::any_of(target.batch, [&](const work& item){
+            return std::ranges::contains(item.ids, target.crashed_in);
+        });
+        for(const auto& line : target.held)
+        {
+            const auto event = child_event{line};
+            const auto id = event.text("test_id").empty() ? event.text("id") : event.text("test_id");
+            if(finished.contains(id) or (named and id == target.crashed_in))
+                forward(line);
+        }
+
+        if(named)
+        {
+            if(not target.crash_line.empty() and m_settings.forward.has_value()
+               and *m_settings.forward != tester::output::jsonl::jsonl_mode::summary)
+                forward(target.crash_line);
+
+            crashed(target, target.crashed_in, ended, statistics);
+            for(auto& item : target.batch | std::views::reverse)
+            {
+                std::erase(item.ids, target.crashed_in);
+                if(not item.ids.empty())
+                    m_pending.push_front(std::move(item));
+            }
+        }
+        else if(target.batch.size() > 1)
+        {
+            for(auto& item : target.batch | std::views::reverse)
+            {
+                item.alone = true;
+                m_pending.push_front(std::move(item));
+            }
+        }
+        else if(not target.batch.empty())
+        {
+            for(const auto& id : target.batch.front().ids)
+                crashed(target, id, ended, statistics);
+        }
+    }
+
+    // The results of a child that died before its summary, other than the case it died in, into
+    // the run — counted here, since no summary will count them. Returns their ids.
+    std::set<std::string, std::less<>> keep_finished(child& target, tester::data::test_statistics& statistics)
+    {
+        auto finished = std::set<std::string, std::less<>>{};
+        for(auto& [order, result] : target.results)
+        {
+            if(result.test_id == target.crashed_in)
+                continue;
+            finished.insert(result.test_id);
+            statistics.total_tests.fetch_add(1, std::memory_order_relaxed);
+            if(result.success)
+                statistics.successful_tests.fetch_add(1, std::memory_order_relaxed);
+            statistics.successful_assertions.fetch_add(result.assertions_ok, std::memory_order_relaxed);
+            statistics.total_assertions.fetch_add(result.assertions_total, std::memory_order_relaxed);
+            m_results.emplace(order, std::move(result));
+        }
+        return finished;
+    }
+
+    void crashed(const child& target, const std::string& id, std::string_view ended, tester::data::test_statistics& statistics)
+    {
+        const auto found = m_known.find(id);
+        if(found == m_known.end())
+            return;
+
+        auto result = tester::data::test_result{*found->second.metadata};
+        result.success = false;
+        result.output = std::format("child test_runner (pid {}) ended with {} while running {}\n",
+            target.pid, ended, target.crashed_in.empty() ? "this case's group" : "this case");
+        result.output += target.err_tail;
+        m_results.emplace(found->second.order, std::move(result));
+        statistics.total_tests.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+auto read_test_ids(std::string_view source)
+{
+    auto ids = std::optional<std::vector<std::string>>{std::in_place};
+    auto read = [&](std::istream& in)
+    {
+        for(auto line = std::string{}; std::getline(in, line);)
+        {
+            if(not line.empty())
+                ids->push_back(std::move(line));
+        }
+    };
+
+    if(source == "-")
+        read(std::cin);
+    else if(auto file = std::ifstream{std::filesystem::path{source}}; file)
+        read(file);
+    else
+        ids.reset();
+    return ids;
+}
+
+} // namespace
+
+// Every heap allocation in the process is counted against the thread that made it, which is what
+// --resources reports per case and require_max_allocations budgets. It is defined here rather than
+// in the library because replacing operator new is a decision for the whole program, and this is
+// the program. Counting is one thread-local increment on top of malloc's own work.
+namespace {
+
+[[noreturn]] void out_of_memory()
+{
+    throw std::bad_alloc{};
+}
+
+void* allocate(std::size_t size)
+{
+    tester::data::count_allocation(size);
+    for(;;)
+    {
+        if(auto* const memory = std::malloc(size == 0 ? 1 : size))
+            return memory;
+        const auto handler = std::get_new_handler();
+        if(handler == nullptr)
+            out_of_memory();
+        handler();
+    }
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment)
+{
+    tester::data::count_allocation(size);
+    const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    // aligned_alloc takes only sizes that are a multiple of the alignment.
+    const auto rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    for(;;)
+    {
+        if(auto* const memory = std::aligned_alloc(align, rounded))
+            return memory;
+        const auto handler = std::get_new_handler();
+        if(handler == nullptr)
+            out_of_memory();
+        handler();
+    }
+}
+
+template<typename... Alignment>
+void* allocate_or_null(std::size_t size, Alignment... alignment) noexcept
+{
+    try
+    {
+        return allocate(size, alignment...);
+    }
+    catch(...)
+    {
+        return nullptr;
+    }
+}
+
 } // namespace
 
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate_or_null(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate_or_null(size); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate_or_null(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocate_or_null(size, alignment); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(memory); }
+
 // Schema is defined in jsonl.h++ as jsonl::jsonl_context<std::ostream>::schema
 // We duplicate it here as a string literal to avoid header inclusion conflicts with the std module
 static constexpr auto g_schema = "tester-jsonl"sv;
@@ -82,8 +850,12 @@ static auto g_schema_len = std::size_t{0};
 constexpr auto usage =
 R"(test_runner [--help] [--list] [--tags=<tag>]
             [--jsonl[=<summary|failures|trace>]] [--slowest=<N>]
-            [--jobs=<N>] [--jsonl-output-max-bytes=<N>] [--result]
+            [--jobs=<N>] [--durations=<path>] [--jsonl-output-max-bytes=<N>] [--result]
+            [--jsonl-flush=<event|test|batch>]
             [--junit=<path>] [--xunit-xml=<path>]
+            [--shard=<K>/<N>] [--processes=<N>] [--ids-from=<path|->]
+            [--bench-baseline=<file.jsonl>] [--bench-threshold=<percent>]
+            [--resources] [--heaviest=<N>] [--most-allocating=<N>]
             [<tags>]
 Examples:
   test_runner
@@ -92,7 +864,15 @@ Examples:
   test_runner --jsonl=failures --tags=[self]
   test_runner --jsonl=failures --junit=report.xml --tags=[self]
   test_runner --jsonl=trace --slowest=10
+  test_runner --jsonl=trace --jsonl-flush=event
   test_runner --jobs=4 --tags=[self]
+  test_runner --jobs=4 --durations=.tester-durations
+  test_runner --jsonl --shard=2/4
+  test_runner --jsonl=failures --processes=8
+  test_runner --jsonl --tags=[bench] > baseline.jsonl
+  test_runner --tags=[bench] --bench-baseline=baseline.jsonl --bench-threshold=5
+  test_runner --jsonl=trace --resources
+  test_runner --heaviest=10 --most-allocating=10
   test_runner --tags=scenario("My test")
   test_runner --tags=[self][order]
   test_runner --tags="scenario.*Happy"
@@ -126,6 +906,8 @@ int main(int argc, char** argv)
     {
         if(jsonl_crash_output)
         {
+            // Buffered lines first, so the crash event still follows the case's own events.
+            tester::output::jsonl::write_pending_events(STDOUT_FILENO);
             emit_crash_event(
                 STDOUT_FILENO,
                 STDERR_FILENO,
@@ -133,6 +915,7 @@ int main(int argc, char** argv)
                 g_schema_buf.data(),
                 g_schema_len,
                 /*version=*/1,
+                tester::data::current_test_id(),
                 /*emit_result_line=*/true);
         }
 
@@ -152,11 +935,23 @@ int main(int argc, char** argv)
     auto output_name = std::string_view{"console"};
     auto result_line = false;
     auto slowest = std::size_t{0};
+    auto resources = false;
+    auto heaviest = std::size_t{0};
+    auto most_allocating = std::size_t{0};
     // 1 = sequential (default); 0 = hardware_concurrency. Optional CLI override.
     auto jobs = std::optional<std::size_t>{};
+    auto durations_path = std::filesystem::path{};
+    // Absent = run in this process; 0 = hardware_concurrency children.
+    auto processes = std::optional<std::size_t>{};
+    auto shard = std::optional<std::pair<std::size_t, std::size_t>>{};
+    auto ids_from = std::string_view{};
     auto jsonl_mode = tester::output::jsonl::jsonl_mode::failures;
     auto output_max_bytes = std::size_t{16384};
+    auto jsonl_flush = tester::output::jsonl::flush_policy::test;
+    auto jsonl_flush_option = std::string_view{};
     auto junit_path = std::filesystem::path{};
+    auto bench_baseline = std::filesystem::path{};
+    auto bench_threshold = std::optional<double>{};
 
     for(std::string_view option : arguments)
     {
@@ -215,6 +1010,27 @@ int main(int argc, char** argv)
             continue;
         }
 
+        if(option == "--resources")
+        {
+            resources = true;
+            continue;
+        }
+
+        // Rankings over what --resources measures, which either of them turns on.
+        if(option.starts_with("--heaviest=") or option.starts_with("--most-allocating="))
+        {
+            const auto equals = option.find('=');
+            const auto value = option.substr(equals + 1);
+            const auto parsed = parse_usize(value);
+            if(not parsed.has_value())
+            {
+                std::clog << option.substr(0, equals) << " expects a non-negative integer, got: " << value << std::endl;
+                return 1;
+            }
+            (option.starts_with("--heaviest=") ? heaviest : most_allocating) = *parsed;
+            continue;
+        }
+
         if(option.starts_with("--jobs="))
         {
             auto value = option.substr(std::string_view{"--jobs="}.size());
@@ -228,6 +1044,107 @@ int main(int argc, char** argv)
             return 1;
         }
 
+        // 1-based K of N, so --shard=1/4 … --shard=4/4 between them run the whole suite once.
+        if(option.starts_with("--shard="))
+        {
+            const auto value = option.substr(std::string_view{"--shard="}.size());
+            const auto slash = value.find('/');
+            const auto index = parse_usize(value.substr(0, slash));
+            const auto count = slash == std::string_view::npos
+                ? std::optional<std::size_t>{}
+                : parse_usize(value.substr(slash + 1));
+            if(index.has_value() and count.has_value() and *index >= 1 and *index <= *count)
+            {
+                shard.emplace(*index, *count);
+                continue;
+            }
+            std::clog << "--shard expects K/N with 1 <= K <= N, got: " << value << std::endl;
+            return 1;
+        }
+
+        if(option.starts_with("--processes="))
+        {
+            const auto value = option.substr(std::string_view{"--processes="}.size());
+            if(auto parsed = parse_usize(value); parsed.has_value())
+            {
+                processes = *parsed;
+                continue;
+            }
+            std::clog << "--processes expects a non-negative integer, got: " << value << std::endl;
+            return 1;
+        }
+
+        // One test id per line; `-` reads them from stdin, which is how --processes hands a
+        // child its batch.
+        if(option.starts_with("--ids-from="))
+        {
+            ids_from = option.substr(std::string_view{"--ids-from="}.size());
+            if(ids_from.empty())
+            {
+                std::clog << "Missing path for --ids-from" << std::endl;
+                return 1;
+            }
+            continue;
+        }
+
+        // Read before the run to start the longest cases first under --jobs, rewritten after it.
+        if(option.starts_with("--durations="))
+        {
+            const auto value = option.substr(std::string_view{"--durations="}.size());
+            if(value.empty())
+            {
+                std::clog << "Missing path for --durations" << std::endl;
+                return 1;
+            }
+            durations_path = value;
+            continue;
+        }
+
+        // Any JSONL stream an earlier run wrote: its benchmark_result events are the baseline.
+        if(option.starts_with("--bench-baseline="))
+        {
+            const auto value = option.substr(std::string_view{"--bench-baseline="}.size());
+            if(value.empty())
+            {
+                std::clog << "Missing path for --bench-baseline" << std::endl;
+                return 1;
+            }
+            bench_baseline = value;
+            continue;
+        }
+
+        if(option.starts_with("--bench-threshold="))
+        {
+            const auto value = option.substr(std::string_view{"--bench-threshold="}.size());
+            auto parsed = 0.0;
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+            if(error == std::errc{} and end == value.data() + value.size() and parsed >= 0.0)
+            {
+                bench_threshold = parsed;
+                continue;
+            }
+            std::clog << "--bench-threshold expects a non-negative percentage, got: " << value << std::endl;
+            return 1;
+        }
+
+        if(option.starts_with("--jsonl-flush="))
+        {
+            const auto value = option.substr(std::string_view{"--jsonl-flush="}.size());
+            if(value == "event")
+                jsonl_flush = tester::output::jsonl::flush_policy::event;
+            else if(value == "test")
+                jsonl_flush = tester::output::jsonl::flush_policy::test;
+            else if(value == "batch")
+                jsonl_flush = tester::output::jsonl::flush_policy::batch;
+            else
+            {
+                std::clog << "--jsonl-flush expects event, test or batch, got: " << value << std::endl;
+                return 1;
+            }
+            jsonl_flush_option = option;
+            continue;
+        }
+
         if(option.starts_with("--jsonl-output-max-bytes="))
         {
             auto value = option.substr(std::string_view{"--jsonl-output-max-bytes="}.size());
@@ -267,11 +1184,31 @@ int main(int argc, char** argv)
         // It handles its own internal configuration.
         tester::set_run_argv(argc, argv);
         tester::set_slowest(slowest);
+        tester::set_allocations_counted(true);
+        tester::set_resources(resources);
+        tester::set_heaviest(heaviest);
+        tester::set_most_allocating(most_allocating);
         if(jobs.has_value())
             tester::set_jobs(*jobs);
-        tester::output::register_observer(
-            "jsonl",
-            tester::output::jsonl::observer_instance(std::cout, std::clog, jsonl_mode, output_max_bytes));
+        tester::set_durations(durations_path);
+        if(not bench_baseline.empty())
+        {
+            // A typo here would compare against nothing and pass every benchmark.
+            if(auto file = std::ifstream{bench_baseline}; not file)
+            {
+                std::clog << "Cannot read benchmark baseline " << bench_baseline.string() << std::endl;
+                return 1;
+            }
+            tester::set_bench_baseline(bench_baseline);
+        }
+        if(bench_threshold.has_value())
+            tester::set_bench_threshold(*bench_threshold);
+        // A --processes parent forwards its children's lines to std::cout from this thread, so
+        // its own few events are written here too rather than by a writer racing the forwarding.
+        // The children run the tests, and they get the policy.
+        const auto own_flush = processes.has_value() ? tester::output::jsonl::flush_policy::event : jsonl_flush;
+        auto& jsonl = tester::output::jsonl::observer_instance(std::cout, std::clog, jsonl_mode, output_max_bytes, own_flush);
+        tester::output::register_observer("jsonl", jsonl);
         tester::output::register_observer(
             "console",
             tester::output::console::observer_instance(std::clog, std::clog, result_line));
@@ -291,6 +1228,18 @@ int main(int argc, char** argv)
         jsonl_crash_output = output_name == "jsonl";
 
         auto tr = tester::runner{tags};
+        if(shard.has_value())
+            tr.shard(shard->first, shard->second);
+        if(not ids_from.empty())
+        {
+            const auto ids = read_test_ids(ids_from);
+            if(not ids.has_value())
+            {
+                std::clog << "Cannot read test ids from " << ids_from << std::endl;
+                return 1;
+            }
+            tr.only(*ids);
+        }
 
         if(list_only)
         {
@@ -298,7 +1247,55 @@ int main(int argc, char** argv)
             return 0;
         }
 
-        tr.run_tests();
+        // Outlives the reporting below: the results it hands back point into it.
+        auto pool = std::optional<process_pool>{};
+        if(processes.has_value())
+        {
+            // The parent reads results back from the children's JSONL. Trace carries every
+            // result; failures carries only the failed ones, which is enough unless a sink here
+            // lists passing cases too — the console, a JUnit report, a slowest ranking — or
+            // --durations records them.
+            const auto children_trace = output_name != "jsonl" or jsonl_mode == tester::output::jsonl::jsonl_mode::trace
+                or not junit_path.empty() or slowest > 0 or heaviest > 0 or most_allocating > 0
+                or not durations_path.empty();
+            auto children = process_pool::settings{
+                .processes = *processes == 0
+                    ? std::max<std::size_t>(1, std::thread::hardware_concurrency())
+                    : *processes,
+                .program = argv[0],
+                .arguments = {
+                    children_trace ? "--jsonl=trace" : "--jsonl=failures",
+                    "--ids-from=-",
+                    std::format("--jsonl-output-max-bytes={}", output_max_bytes)},
+                .parent_run_id = std::string{jsonl.run_id()},
+                .forward = output_name == "jsonl"
+                    ? std::optional{jsonl_mode}
+                    : std::nullopt};
+            if(not tags.empty())
+                children.arguments.push_back(std::format("--tags={}", tags));
+            if(jobs.has_value())
+                children.arguments.push_back(std::format("--jobs={}", *jobs));
+            if(not jsonl_flush_option.empty())
+                children.arguments.emplace_back(jsonl_flush_option);
+            if(not bench_baseline.empty())
+                children.arguments.push_back(std::format("--bench-baseline={}", bench_baseline.string()));
+            if(bench_threshold.has_value())
+                children.arguments.push_back(std::format("--bench-threshold={}", *bench_threshold));
+            // The children measure, the parent ranks what they report.
+            if(resources or heaviest > 0 or most_allocating > 0)
+                children.arguments.emplace_back("--resources");
+
+            // A child that dies before reading its ids must not take the parent with it.
+            std::signal(SIGPIPE, SIG_IGN);
+            pool.emplace(std::move(children), tr.runnable_groups());
+            tr.run_tests([&](tester::data::execution_context& execution)
+            {
+                pool->run(execution);
+                tester::save_durations(execution);
+            });
+        }
+        else
+            tr.run_tests();
         tr.report_results();
         tr.report_failures();
         tr.report_summary();
@@ -1037,6 +1037,31 @@ auto register_tests()
         check_eq(3, 3); // unreachable
     };
 
+    test_case("test_case [.probe-passing-detail] passing assertions only") = []
+    {
+        check_eq(1, 1);
+        check_contains(std::string{"abcdef"}, "cde");
+        check_container_eq(std::vector{1, 2}, std::vector{1, 2});
+    };
+
+    test_case("test_case [self] passing assertions are described only to a sink that asks") = []
+    {
+        // Trace wants assertion_passed, so every passing check still becomes an event.
+        const auto trace = run_test_runner({"--jsonl=trace", "--tags=[.probe-passing-detail]"});
+        require_eq(trace.exit_code, 0);
+        require_false(find_event(trace.stdout_text, "assertion_passed", 2).empty());
+        require_eq(field(find_event(trace.stdout_text, "assertion_passed", 1), "expected"),
+                   std::string{"\"contains: cde\""});
+
+        // The console only asks when verbose, so a quiet run counts the checks and formats
+        // none of them: the case header is there, the operand lines are not.
+        const auto console = run_test_runner({"--result", "--tags=[.probe-passing-detail]"});
+        require_eq(console.exit_code, 0);
+        require_contains(console.stderr_text, std::string{"passing assertions only"});
+        require_false(console.stderr_text.contains("actual:"));
+        require_contains(console.stderr_text, std::string{"assertions_ok=3 assertions_total=3"});
+    };
+
     test_case("test_case [self] succeed and failed adjust assertion counts") = []
     {
         const auto result = probe("[.probe-messages]");
@@ -0,0 +1,152 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+#include "details/selftest_spawn.h++"
+
+import std;
+import tester;
+
+namespace tester::selftest::bench {
+
+namespace {
+
+auto temp_baseline_path(std::string_view stem)
+{
+    return std::filesystem::temp_directory_path()
+        / (std::string{stem} + "_"
+           + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())
+           + ".jsonl");
+}
+
+// The stream a run wrote, with one benchmark's median swapped for `median`: a baseline that
+// differs from the measurement by as much as a test needs, without sleeping to make it so.
+auto baseline_with_median(std::string_view stream, std::string_view median)
+{
+    auto line = tester_selftest::find_event(stream, "benchmark_result");
+    const auto key = std::string_view{"\"median_ns\":"};
+    const auto at = line.find(key) + key.size();
+    line.replace(at, tester_selftest::field(line, "median_ns").size(), median);
+    return line + '\n';
+}
+
+} // namespace
+
+auto register_tests()
+{
+    using tester::basic::test_case;
+    using tester::bench::benchmark;
+    using namespace tester::assertions;
+    using tester_selftest::run_test_runner;
+
+    benchmark("sum of a vector [.bench-probe]") = [](tester::bench::state& s)
+    {
+        const auto values = std::vector<int>(256, 1);
+        for(auto _ : s)
+        {
+            auto total = std::accumulate(values.begin(), values.end(), 0);
+            tester::bench::do_not_optimize(total);
+        }
+        s.items_per_iteration(values.size());
+        s.bytes_per_iteration(values.size() * sizeof(int));
+    };
+
+    test_case("test_case [self][bench] state runs its loop the iteration count it was given") = []
+    {
+        auto s = tester::bench::state{5};
+        auto iterations = 0;
+        for(auto _ : s)
+            ++iterations;
+
+        require_eq(iterations, 5);
+        require_true(s.finished());
+        check_true(s.elapsed() >= std::chrono::nanoseconds{0});
+    };
+
+    test_case("test_case [self][bench] a benchmark is listed and filtered like a test_case") = []
+    {
+        const auto result = run_test_runner({"--list", "--jsonl", "--tags=[.bench-probe]"});
+        require_eq(result.exit_code, 0);
+
+        const auto listed = tester_selftest::find_event(result.stdout_text, "registered_test");
+        require_true(tester_selftest::field(listed, "name").contains("benchmark -> sum of a vector"));
+        require_true(tester_selftest::find_event(result.stdout_text, "registered_test", 1).empty());
+    };
+
+    test_case("test_case [self][bench] a benchmark is filtered and sharded like a test_case") = []
+    {
+        // Hidden unless asked for by name: another tag does not list it.
+        const auto listed = run_test_runner({"--list", "--jsonl", "--tags=[self]"});
+        require_eq(listed.exit_code, 0);
+        check_false(listed.stdout_text.contains("sum of a vector"));
+
+        // One shard of two runs it, and the other does not.
+        auto runs = 0;
+        for(const auto* shard : {"--shard=1/2", "--shard=2/2"})
+        {
+            const auto result = run_test_runner({"--jsonl=summary", "--tags=[.bench-probe]", shard});
+            require_eq(result.exit_code, 0);
+            if(not tester_selftest::find_event(result.stdout_text, "benchmark_result").empty())
+                ++runs;
+        }
+        check_eq(runs, 1);
+    };
+
+    test_case("test_case [self][bench] a benchmark reports its samples as a benchmark_result") = []
+    {
+        const auto result = run_test_runner({"--jsonl=summary", "--tags=[.bench-probe]"});
+        require_eq(result.exit_code, 0);
+
+        // Every mode writes it, so a summary stream can be the next run's baseline.
+        const auto event = tester_selftest::find_event(result.stdout_text, "benchmark_result");
+        require_false(event.empty());
+        require_true(tester_selftest::field(event, "id").contains("sum of a vector"));
+        require_eq(tester_selftest::field(event, "samples"), std::string{"10"});
+        require_neq(tester_selftest::field(event, "iterations"), std::string{"0"});
+        require_false(tester_selftest::field(event, "median_ns").empty());
+        require_false(tester_selftest::field(event, "min_ns").empty());
+        require_false(tester_selftest::field(event, "items_per_second").empty());
+        require_false(tester_selftest::field(event, "bytes_per_second").empty());
+        require_true(tester_selftest::field(event, "baseline_median_ns").empty());
+    };
+
+    test_case("test_case [self][bench] --bench-baseline fails a benchmark beyond the threshold") = []
+    {
+        const auto first = run_test_runner({"--jsonl=summary", "--tags=[.bench-probe]"});
+        require_eq(first.exit_code, 0);
+
+        const auto path = temp_baseline_path("tester_bench_baseline");
+        auto compare = [&](std::string_view median)
+        {
+            std::ofstream{path} << baseline_with_median(first.stdout_text, median);
+            return run_test_runner({"--jsonl=failures", "--tags=[.bench-probe]",
+                "--bench-baseline=" + path.string(), "--bench-threshold=50"});
+        };
+
+        // Far slower than now: within the threshold, and the event says what it compared with.
+        const auto faster = compare("1000000000.0");
+        const auto kept = tester_selftest::find_event(faster.stdout_text, "benchmark_result");
+        check_eq(faster.exit_code, 0);
+        check_eq(tester_selftest::field(kept, "baseline_median_ns"), std::string{"1000000000.000"});
+        check_eq(tester_selftest::field(kept, "regressed"), std::string{"false"});
+
+        // Far faster than now: a regression, which fails the case and the run.
+        const auto slower = compare("0.001");
+        const auto regressed = tester_selftest::find_event(slower.stdout_text, "benchmark_result");
+        check_eq(slower.exit_code, 1);
+        check_eq(tester_selftest::field(regressed, "regressed"), std::string{"true"});
+        check_true(tester_selftest::event_field(slower.stdout_text, "summary", "failed_test_ids").contains("sum of a vector"));
+
+        auto ec = std::error_code{};
+        std::filesystem::remove(path, ec);
+
+        const auto missing = run_test_runner({"--tags=[.bench-probe]", "--bench-baseline=" + path.string()});
+        check_eq(missing.exit_code, 1);
+    };
+
+    return 0;
+}
+
+const auto _ = register_tests();
+
+} // namespace tester::selftest::bench
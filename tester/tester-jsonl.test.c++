@@ -10,9 +10,32 @@ import tester;
 
 namespace tester::selftest::jsonl {
 
+namespace {
+
+auto lines_of(std::string_view text)
+{
+    auto lines = std::vector<std::string_view>{};
+    for(auto line : std::views::split(text, '\n'))
+        if(not line.empty())
+            lines.emplace_back(line.begin(), line.end());
+    return lines;
+}
+
+// Where the first line containing every one of `needles` is, or the end.
+auto index_of(const std::vector<std::string_view>& lines, std::initializer_list<std::string_view> needles, std::size_t from = 0)
+{
+    for(auto at = from; at < lines.size(); ++at)
+        if(std::ranges::all_of(needles, [&](std::string_view needle){ return lines[at].contains(needle); }))
+            return at;
+    return lines.size();
+}
+
+} // namespace
+
 auto register_tests()
 {
     using tester::basic::test_case;
+    using tester::basic::test_order;
     using namespace tester::assertions;
     using tester_selftest::run_test_runner;
 
@@ -224,6 +247,112 @@ auto register_tests()
         check_eq(0.5, 1.0);
     };
 
+    // ========================================================================
+    // --jsonl-flush. The policies decide when lines reach the stream, never
+    // which lines or in what order one thread wrote them.
+    // ========================================================================
+
+    test_case("test_case [self] --jsonl-flush writes the same events in order under every policy") = []
+    {
+        for(const auto* policy : {"--jsonl-flush=event", "--jsonl-flush=test", "--jsonl-flush=batch"})
+        {
+            const auto result = run_test_runner({"--jsonl=trace", "--jobs=2", policy, "--tags=[.jsonl-flush-probe]"});
+            require_eq(result.exit_code, 0);
+
+            const auto lines = lines_of(result.stdout_text);
+            require_false(lines.empty());
+            require_true(lines.front().contains("\"type\":\"meta\""));
+            require_true(lines.back().contains("\"type\":\"eof\""));
+            const auto summary = index_of(lines, {"\"type\":\"summary\""});
+            require_true(summary < lines.size());
+
+            // Each case's assertions follow its case line, all of them, and precede the summary.
+            for(const auto* id : {"\"jsonl_flush_probe_a\"", "\"jsonl_flush_probe_b\""})
+            {
+                const auto id_field = std::string{"\"id\":"} + id;
+                const auto test_id_field = std::string{"\"test_id\":"} + id;
+                const auto started = index_of(lines, {"\"type\":\"case\"", id_field});
+                require_true(started < summary);
+
+                auto passed = std::size_t{0};
+                for(auto at = std::size_t{0}; at < lines.size(); ++at)
+                {
+                    if(not lines[at].contains("\"type\":\"assertion_passed\"") or not lines[at].contains(test_id_field))
+                        continue;
+                    ++passed;
+                    check_true(at > started and at < summary);
+                }
+                check_eq(passed, 200uz);
+            }
+        }
+
+        const auto unknown = run_test_runner({"--jsonl=trace", "--jsonl-flush=sometimes", "--tags=[.jsonl-flush-probe]"});
+        check_eq(unknown.exit_code, 1);
+    };
+
+    test_case("test_case [.jsonl-flush-probe] first of two",
+              test_order{.priority = 0, .depends_on = {}, .id = "jsonl_flush_probe_a"}) = []
+    {
+        for(auto i = 0; i < 200; ++i)
+            check_eq(i, i);
+    };
+
+    test_case("test_case [.jsonl-flush-probe] second of two",
+              test_order{.priority = 0, .depends_on = {}, .id = "jsonl_flush_probe_b"}) = []
+    {
+        for(auto i = 0; i < 200; ++i)
+            check_eq(i, i);
+    };
+
+    test_case("test_case [self] a crash writes the buffered events before its crash event") = []
+    {
+        // Batch holds the crashing case's lines until the end of the run, which never comes.
+        const auto result = run_test_runner({"--jsonl=trace", "--jsonl-flush=batch", "--tags=[.jsonl-crash-probe]"});
+        require_neq(result.exit_code, 0);
+
+        const auto lines = lines_of(result.stdout_text);
+        const auto passed = index_of(lines, {"\"type\":\"assertion_passed\"", "\"test_id\":\"jsonl_crash_probe\""});
+        const auto crash = index_of(lines, {"\"type\":\"crash\""});
+        require_true(passed < lines.size());
+        require_true(crash < lines.size());
+        require_true(passed < crash);
+        check_true(lines.front().contains("\"type\":\"meta\""));
+    };
+
+    test_case("test_case [self] a crash while the writer is busy leaves only whole lines") = []
+    {
+        // One worker keeps the writer thread writing 64 KiB batches while the other aborts.
+        const auto result = run_test_runner(
+            {"--jsonl=trace", "--jsonl-flush=batch", "--jobs=2", "--tags=[.jsonl-busy-crash-probe]"});
+        require_neq(result.exit_code, 0);
+
+        const auto lines = lines_of(result.stdout_text);
+        require_true(index_of(lines, {"\"type\":\"crash\""}) < lines.size());
+        for(const auto line : lines)
+            check_true(line.starts_with('{') and line.ends_with('}'));
+    };
+
+    test_case("test_case [.jsonl-busy-crash-probe] streams passing checks",
+              test_order{.priority = 0, .depends_on = {}, .id = "jsonl_busy_crash_probe_stream"}) = []
+    {
+        for(auto i = 0; i < 1'000'000; ++i)
+            check_eq(i, i);
+    };
+
+    test_case("test_case [.jsonl-busy-crash-probe] aborts while the other streams",
+              test_order{.priority = 0, .depends_on = {}, .id = "jsonl_busy_crash_probe_abort"}) = []
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        std::abort();
+    };
+
+    test_case("test_case [.jsonl-crash-probe] aborts after a passing check",
+              test_order{.priority = 0, .depends_on = {}, .id = "jsonl_crash_probe"}) = []
+    {
+        check_eq(1, 1);
+        std::abort();
+    };
+
     return 0;
 }
 
@@ -0,0 +1,123 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+#include "details/selftest_spawn.h++"
+
+import std;
+import tester;
+
+namespace tester::selftest::resources {
+
+namespace {
+
+// A property's value from a JUnit report, or empty.
+auto junit_property(std::string_view report, std::string_view name)
+{
+    const auto key = std::format("<property name=\"{}\" value=\"", name);
+    const auto at = report.find(key);
+    if(at == std::string_view::npos)
+        return std::string{};
+    const auto from = at + key.size();
+    return std::string{report.substr(from, report.find('"', from) - from)};
+}
+
+} // namespace
+
+auto register_tests()
+{
+    using tester::basic::test_case;
+    using namespace tester::assertions;
+    using tester_selftest::run_test_runner;
+
+    test_case("test_case [.resources-probe] allocates a thousand strings") = []
+    {
+        auto strings = std::vector<std::string>{};
+        for(auto i = 0; i < 1000; ++i)
+            strings.push_back(std::string(64, 'x'));
+        check_eq(strings.size(), 1000uz);
+    };
+
+    test_case("test_case [.allocation-reporting-probe] allocates a little and checks a lot") = []
+    {
+        auto kept = std::vector<std::unique_ptr<int>>{};
+        for(auto i = 0; i < 4; ++i)
+            kept.push_back(std::make_unique<int>(i));
+        for(auto i = 0; i < 200; ++i)
+            check_eq(std::string{"operands the trace formats"}.size(), 26uz);
+    };
+
+    test_case("test_case [.allocation-budget-probe] exceeds its allocation budget") = []
+    {
+        require_max_allocations(1, []{ auto held = std::vector<std::unique_ptr<int>>{};
+                                       for(auto i = 0; i < 8; ++i) held.push_back(std::make_unique<int>(i)); });
+    };
+
+    test_case("test_case [self][resources] require_max_allocations counts what its body allocates") = []
+    {
+        require_max_allocations(0, []{ auto total = 0; for(auto i = 0; i < 8; ++i) total += i; return total; });
+        require_max_allocations(1, []{ auto kept = std::make_unique<int>(42); });
+    };
+
+    test_case("test_case [self][resources] --resources reports a case's CPU time and allocations") = []
+    {
+        const auto result = run_test_runner({"--jsonl=trace", "--resources", "--tags=[.resources-probe]"});
+        require_eq(result.exit_code, 0);
+
+        const auto event = tester_selftest::find_event(result.stdout_text, "test");
+        require_false(event.empty());
+        check_false(tester_selftest::field(event, "cpu_ns").empty());
+        check_true(std::stoull(tester_selftest::field(event, "allocations")) >= 1000);
+        check_true(std::stoull(tester_selftest::field(event, "allocated_bytes")) >= 64'000);
+        // One case at a time, so the process-wide peak is this case's to report.
+        check_false(tester_selftest::field(event, "peak_rss_growth_bytes").empty());
+
+        // Without the flag the event is what it always was.
+        const auto plain = run_test_runner({"--jsonl=trace", "--tags=[.resources-probe]"});
+        check_true(tester_selftest::field(tester_selftest::find_event(plain.stdout_text, "test"), "cpu_ns").empty());
+    };
+
+    test_case("test_case [self][resources] reporting an assertion is not charged to the case") = []
+    {
+        const auto report = std::filesystem::temp_directory_path()
+            / ("tester_resources_"
+               + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())
+               + ".xml");
+
+        // Trace describes every passing check; summary with a JUnit report describes none.
+        const auto traced = run_test_runner({"--jsonl=trace", "--resources", "--tags=[.allocation-reporting-probe]"});
+        const auto quiet = run_test_runner(
+            {"--jsonl=summary", "--resources", "--junit=" + report.string(), "--tags=[.allocation-reporting-probe]"});
+        const auto xml = tester_selftest::read_file_text(report);
+        auto ec = std::error_code{};
+        std::filesystem::remove(report, ec);
+        require_eq(traced.exit_code, 0);
+        require_eq(quiet.exit_code, 0);
+
+        const auto counted = tester_selftest::event_field(traced.stdout_text, "test", "allocations");
+        require_false(counted.empty());
+        check_eq(counted, junit_property(xml, "allocations"));
+        check_eq(tester_selftest::event_field(traced.stdout_text, "test", "allocated_bytes"),
+                 junit_property(xml, "allocated_bytes"));
+    };
+
+    test_case("test_case [self][resources] --most-allocating ranks cases in the trace summary") = []
+    {
+        const auto result = run_test_runner({"--jsonl=trace", "--most-allocating=1", "--tags=[.resources-probe]"});
+        require_eq(result.exit_code, 0);
+        check_true(tester_selftest::event_field(result.stdout_text, "summary", "most_allocating").contains("allocates a thousand strings"));
+    };
+
+    test_case("test_case [self][resources] an exceeded allocation budget fails the case") = []
+    {
+        const auto result = run_test_runner({"--jsonl=failures", "--tags=[.allocation-budget-probe]"});
+        check_eq(result.exit_code, 1);
+        check_true(tester_selftest::event_field(result.stdout_text, "summary", "failed_test_ids").contains("exceeds its allocation budget"));
+    };
+
+    return 0;
+}
+
+const auto _ = register_tests();
+
+} // namespace tester::selftest::resources
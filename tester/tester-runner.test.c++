@@ -225,6 +225,140 @@ auto register_parallel_thread_assert_probe()
 
 const auto _parallel_thread_assert_probe = register_parallel_thread_assert_probe();
 
+// A long case beside a short depends_on chain. The wave scheduler ran the chain's child only
+// once the whole first wave — the long case included — had joined; a pool that steals runs it
+// on the worker the root freed. The child also registers a case mid-run, so the scheduler has
+// to take up work a worker hands it as well as the catalogue it started with.
+auto register_steal_probe()
+{
+    if(std::getenv("TESTER_STEAL_PROBE") == nullptr)
+        return 0;
+
+    using tester::basic::test_case;
+    using tester::basic::test_order;
+    using namespace tester::assertions;
+
+    static auto slow_started = std::atomic<bool>{false};
+    static auto slow_finished = std::atomic<bool>{false};
+
+    test_case("test_case [.steal-probe] long independent",
+              test_order{.priority = 0, .depends_on = {}, .id = "steal_probe_slow"}) = []
+    {
+        slow_started.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds{400});
+        slow_finished.store(true);
+        require_true(true);
+    };
+
+    test_case("test_case [.steal-probe] chain root",
+              test_order{.priority = 0, .depends_on = {}, .id = "steal_probe_root"}) = []
+    {
+        require_true(true);
+    };
+
+    test_case("test_case [.steal-probe] chain child",
+              test_order{.priority = 0, .depends_on = {"steal_probe_root"}, .id = "steal_probe_child"}) = []
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+        while(not slow_started.load() and std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        require_true(slow_started.load());
+        require_false(slow_finished.load());
+
+        test_case("test_case [.steal-probe] registered by the child",
+                  test_order{.priority = 0, .depends_on = {"steal_probe_child"}, .id = "steal_probe_nested"}) = []
+        {
+            require_true(true);
+        };
+    };
+
+    return 0;
+}
+
+const auto _steal_probe = register_steal_probe();
+
+// A suite for --processes and --shard: passing and failing cases, a depends_on pair that has to
+// land in one child and one shard, and a case that aborts. Hidden unless the env is set.
+auto register_process_probe()
+{
+    if(std::getenv("TESTER_PROCESS_PROBE") == nullptr)
+        return 0;
+
+    using tester::basic::test_case;
+    using tester::basic::test_order;
+    using namespace tester::assertions;
+
+    static auto root_pid = std::atomic<int>{0};
+
+    test_case("test_case [.process-probe] passes") = []
+    {
+        check_eq(1, 1);
+        require_true(true);
+    };
+
+    test_case("test_case [.process-probe] fails") = []
+    {
+        check_eq(1, 2);
+    };
+
+    test_case("test_case [.process-probe] aborts",
+              test_order{.priority = 0, .depends_on = {}, .id = "process_probe_abort"}) = []
+    {
+        std::abort();
+    };
+
+    test_case("test_case [.process-probe] dependency root",
+              test_order{.priority = 0, .depends_on = {}, .id = "process_probe_root"}) = []
+    {
+        root_pid.store(1);
+        require_true(true);
+    };
+
+    // Reads what the root wrote, which only works if both ran in one process.
+    test_case("test_case [.process-probe] dependency child",
+              test_order{.priority = 0, .depends_on = {"process_probe_root"}, .id = "process_probe_child"}) = []
+    {
+        require_eq(root_pid.load(), 1);
+    };
+
+    return 0;
+}
+
+const auto _process_probe = register_process_probe();
+
+// Enough groups that --processes=1 hands out batches of two, the first of which is a case that
+// finishes and then one that aborts. Each case appends its id to the file the env names, so a
+// case that ran twice shows up twice.
+auto register_crash_batch_probe()
+{
+    const auto* log = std::getenv("TESTER_CRASH_BATCH_PROBE");
+    if(log == nullptr)
+        return 0;
+
+    using tester::basic::test_case;
+    using tester::basic::test_order;
+
+    static const auto log_path = std::string{log};
+    const auto recording = [](std::string id)
+    {
+        return [id = std::move(id)]{ std::ofstream{log_path, std::ios::app} << id << '\n'; };
+    };
+
+    test_case("test_case [.crash-batch-probe] records 0",
+              test_order{.priority = 0, .depends_on = {}, .id = "crash_batch_0"}) = recording("crash_batch_0");
+    test_case("test_case [.crash-batch-probe] aborts",
+              test_order{.priority = 0, .depends_on = {}, .id = "crash_batch_abort"}) = []{ std::abort(); };
+    for(auto i = 1; i < 8; ++i)
+    {
+        const auto id = std::format("crash_batch_{}", i);
+        test_case(std::format("test_case [.crash-batch-probe] records {}", i),
+                  test_order{.priority = 0, .depends_on = {}, .id = id}) = recording(id);
+    }
+    return 0;
+}
+
+const auto _crash_batch_probe = register_crash_batch_probe();
+
 // Reports that worker_count() matches the --jobs flag the child was started with.
 auto register_worker_count_probe()
 {
@@ -650,6 +784,164 @@ auto register_tests()
         require_eq(tester_selftest::field(summary, "tests_ok"), std::string{"5"});
     };
 
+    test_case("test_case [self][parallel] a long case does not hold back the cases released beside it") = []
+    {
+        const auto result = run_test_runner(
+            {"--jsonl=failures", "--jobs=2", "--tags=[.steal-probe]"},
+            "TESTER_STEAL_PROBE=1 ");
+
+        require_false(result.signaled);
+        require_eq(result.exit_code, 0);
+        const auto summary = tester_selftest::find_event(result.stdout_text, "summary");
+        require_eq(tester_selftest::field(summary, "passed"), std::string{"true"});
+        // Three registered up front and the one the chain child registers while it runs.
+        require_eq(tester_selftest::field(summary, "tests_ok"), std::string{"4"});
+    };
+
+    test_case("test_case [self][parallel] --durations records each case for the next run") = []
+    {
+        const auto history = std::filesystem::temp_directory_path()
+            / ("tester_durations_"
+               + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        auto ec = std::error_code{};
+        std::filesystem::remove(history, ec);
+
+        // The second run reads what the first wrote, so both orderings have to pass.
+        for(auto run = 0; run < 2; ++run)
+        {
+            const auto result = run_test_runner(
+                {"--jsonl=failures", "--jobs=2", "--durations=" + history.string(), "--tags=[.steal-probe]"},
+                "TESTER_STEAL_PROBE=1 ");
+            require_false(result.signaled);
+            require_eq(result.exit_code, 0);
+        }
+
+        const auto recorded = tester_selftest::read_file_text(history);
+        std::filesystem::remove(history, ec);
+        require_true(recorded.contains(" steal_probe_slow\n"));
+        require_true(recorded.contains(" steal_probe_nested\n"));
+    };
+
+    test_case("test_case [self][parallel] --durations records the children's cases under --processes") = []
+    {
+        const auto history = std::filesystem::temp_directory_path()
+            / ("tester_process_durations_"
+               + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        auto ec = std::error_code{};
+        std::filesystem::remove(history, ec);
+
+        // Failures mode, so the passing cases reach the parent only because --durations asks.
+        const auto result = run_test_runner(
+            {"--jsonl=failures", "--processes=2", "--durations=" + history.string(), "--tags=[.process-probe]"},
+            "TESTER_PROCESS_PROBE=1 ");
+        require_false(result.signaled);
+
+        const auto recorded = tester_selftest::read_file_text(history);
+        std::filesystem::remove(history, ec);
+        require_true(recorded.contains(" process_probe_root\n"));
+        require_true(recorded.contains(" process_probe_child\n"));
+    };
+
+    test_case("test_case [self][parallel] --processes merges children into one run and fails a crashing case") = []
+    {
+        const auto result = run_test_runner(
+            {"--jsonl=trace", "--processes=2", "--tags=[.process-probe]"},
+            "TESTER_PROCESS_PROBE=1 ");
+
+        require_false(result.signaled);
+        require_eq(result.exit_code, 1);
+
+        // One run, however many children: a single summary and run_end, closed by one eof.
+        const auto summary = tester_selftest::find_event(result.stdout_text, "summary");
+        require_false(summary.empty());
+        require_true(tester_selftest::find_event(result.stdout_text, "summary", 1).empty());
+        require_false(tester_selftest::find_event(result.stdout_text, "run_end").empty());
+        require_true(tester_selftest::find_event(result.stdout_text, "run_end", 1).empty());
+        require_true(tester_selftest::find_event(result.stdout_text, "eof", 1).empty());
+
+        require_eq(tester_selftest::field(summary, "tests_total"), std::string{"5"});
+        require_eq(tester_selftest::field(summary, "tests_ok"), std::string{"3"});
+        const auto failed = tester_selftest::field(summary, "failed_test_ids");
+        require_true(failed.contains("process_probe_abort"));
+        require_true(failed.contains("fails"));
+
+        // The abort is the child's crash event, naming the case, and a failed result.
+        const auto crash = tester_selftest::find_event(result.stdout_text, "crash");
+        require_eq(tester_selftest::field(crash, "test_id"), std::string{"\"process_probe_abort\""});
+    };
+
+    test_case("test_case [self][parallel] --processes keeps what a crashed child finished and reruns only the rest") = []
+    {
+        const auto log = std::filesystem::temp_directory_path()
+            / ("tester_crash_batch_"
+               + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+        auto ec = std::error_code{};
+        std::filesystem::remove(log, ec);
+
+        const auto result = run_test_runner(
+            {"--jsonl=failures", "--processes=1", "--tags=[.crash-batch-probe]"},
+            "TESTER_CRASH_BATCH_PROBE=" + log.string() + " ");
+        const auto recorded = tester_selftest::read_file_text(log);
+        std::filesystem::remove(log, ec);
+
+        require_false(result.signaled);
+        require_eq(result.exit_code, 1);
+        const auto summary = tester_selftest::find_event(result.stdout_text, "summary");
+        check_eq(tester_selftest::field(summary, "tests_total"), std::string{"9"});
+        check_eq(tester_selftest::field(summary, "tests_ok"), std::string{"8"});
+
+        // Every recording case ran exactly once, including the one that shared the abort's batch.
+        for(auto i = 0; i < 8; ++i)
+        {
+            const auto line = std::format("crash_batch_{}\n", i);
+            const auto first = recorded.find(line);
+            require_neq(first, std::string::npos);
+            check_eq(recorded.find(line, first + 1), std::string::npos);
+        }
+    };
+
+    test_case("test_case [self][parallel] --shard splits the catalogue and keeps depends_on together") = []
+    {
+        auto listed = [](std::string_view extra)
+        {
+            auto args = std::vector<std::string>{"--list", "--jsonl", "--tags=[.process-probe]"};
+            if(not extra.empty())
+                args.emplace_back(extra);
+            const auto result = run_test_runner(args, "TESTER_PROCESS_PROBE=1 ");
+            auto ids = std::vector<std::string>{};
+            for(auto skip = std::size_t{0};; ++skip)
+            {
+                const auto line = tester_selftest::find_event(result.stdout_text, "registered_test", skip);
+                if(line.empty())
+                    break;
+                ids.push_back(tester_selftest::field(line, "id"));
+            }
+            return ids;
+        };
+
+        auto whole = listed({});
+        require_eq(whole.size(), 5uz);
+
+        auto shards = std::vector<std::string>{};
+        for(const auto* shard : {"--shard=1/3", "--shard=2/3", "--shard=3/3"})
+        {
+            const auto ids = listed(shard);
+            const auto has_root = std::ranges::contains(ids, std::string{"\"process_probe_root\""});
+            const auto has_child = std::ranges::contains(ids, std::string{"\"process_probe_child\""});
+            require_eq(has_root, has_child);
+            // The same shard twice is the same slice.
+            require_true(std::ranges::equal(ids, listed(shard)));
+            shards.append_range(ids);
+        }
+
+        std::ranges::sort(whole);
+        std::ranges::sort(shards);
+        require_true(whole == shards);
+
+        const auto refused = run_test_runner({"--list", "--shard=4/3"});
+        require_eq(refused.exit_code, 1);
+    };
+
     test_case("test_case [self][parallel] worker_count maps jobs=0 to hardware concurrency") = []
     {
         // Probe in a child process — set_jobs mutates process-global g_config and races
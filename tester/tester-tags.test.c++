@@ -42,6 +42,28 @@ auto register_tests()
         require_true(summary_line.contains("\"matched_total\":1"));
     };
 
+    test_case("test_case [self] every tag of a multi-tag filter is required") = []
+    {
+        const auto both = run_test_runner({
+            "--jsonl=failures",
+            "--list",
+            "--tags=[self][beta]"});
+
+        require_eq(both.exit_code, 0);
+        require_true(both.stdout_text.contains("\"tags\":[\"self\",\"beta\"]"));
+        require_false(both.stdout_text.contains("\"tags\":[\"self\",\"alpha\"]"));
+        require_eq(tester_selftest::event_field(both.stdout_text, "test_list_summary", "matched_total"), std::string{"1"});
+
+        // A tag no case carries still gets an id when the filter is read; nothing has its bit.
+        const auto unknown = run_test_runner({
+            "--jsonl=failures",
+            "--list",
+            "--tags=[beta][no-such-tag-ever]"});
+
+        require_eq(unknown.exit_code, 0);
+        require_eq(tester_selftest::event_field(unknown.stdout_text, "test_list_summary", "matched_total"), std::string{"0"});
+    };
+
     test_case("test_case [.hidden-probe] hidden from default run") = []
     {
         require_eq(1, 1);
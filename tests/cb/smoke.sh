@@ -1486,6 +1486,173 @@ test_test_lifecycle() {
   end_case test_lifecycle
 }
 
+test_test_affected() {
+  should_run test_affected || return 0
+  begin_case test_affected
+  local work_dir
+  prepare_work_dir
+  work_dir="${LAST_WORK_DIR}"
+
+  # A stand-in runner: --list reports one test per test unit, a run echoes the ids it was
+  # asked for (all of them without --ids-from=), so the stream shows what CB selected.
+  printf '%s\n' \
+    'import std;' \
+    'int main(int argc, char* argv[])' \
+    '{' \
+    '    auto ids = std::vector<std::string>{"alpha_case", "beta_case"};' \
+    '    for(const auto arg : std::span{argv + 1, argv + argc})' \
+    '    {' \
+    '        const auto option = std::string_view{arg};' \
+    '        if(option == "--list")' \
+    '        {' \
+    '            std::puts(R"({"type":"registered_test","id":"alpha_case","file":"alpha.test.c++"})");' \
+    '            std::puts(R"({"type":"registered_test","id":"beta_case","file":"beta.test.c++"})");' \
+    '            return 0;' \
+    '        }' \
+    '        if(option.starts_with("--ids-from="))' \
+    '        {' \
+    '            ids.clear();' \
+    '            auto file = std::ifstream{std::string{option.substr(11)}};' \
+    '            for(auto id = std::string{}; std::getline(file, id);)' \
+    '                ids.push_back(id);' \
+    '        }' \
+    '    }' \
+    '    for(const auto& id : ids)' \
+    '        std::println(R"({{"type":"probe_ran","id":"{}"}})", id);' \
+    '    return 0;' \
+    '}' > "${work_dir}/test_runner.c++"
+  printf '%s\n' \
+    'export module alpha;' \
+    'export int alpha_value() { return 1; }' > "${work_dir}/alpha.c++m"
+  printf '%s\n' \
+    'import alpha;' \
+    'int alpha_probe() { return alpha_value(); }' > "${work_dir}/alpha.test.c++"
+  printf '%s\n' \
+    'int beta_probe() { return 2; }' > "${work_dir}/beta.test.c++"
+
+  # Nothing to compare with yet: everything runs, and the pass becomes the baseline.
+  run_cb_test "${work_dir}" --affected
+  assert_jsonl_event_value test_selection full_run true "affected_first_run_is_full"
+  assert_jsonl_contains '"id":"alpha_case"' "affected_first_run_alpha"
+  assert_jsonl_contains '"id":"beta_case"' "affected_first_run_beta"
+
+  # A module change reaches the test that imports it, and only that one.
+  printf '%s\n' '// interface changed' >> "${work_dir}/alpha.c++m"
+  run_cb_test "${work_dir}" --affected
+  assert_jsonl_event_value test_selection full_run false "affected_module_change_narrowed"
+  assert_jsonl_event_value test_selection selected 1 "affected_module_change_selected"
+  assert_jsonl_contains '"id":"alpha_case"' "affected_module_change_runs_importer"
+  assert_jsonl_not_contains '"id":"beta_case"' "affected_module_change_skips_unrelated"
+
+  printf '%s\n' '// test changed' >> "${work_dir}/beta.test.c++"
+  run_cb_test "${work_dir}" --affected
+  assert_jsonl_contains '"id":"beta_case"' "affected_test_change_runs_itself"
+  assert_jsonl_not_contains '"id":"alpha_case"' "affected_test_change_skips_unrelated"
+
+  # Nothing changed since that pass: nothing to run, and the runner is not started.
+  run_cb_test "${work_dir}" --affected
+  assert_jsonl_event_value test_selection selected 0 "affected_unchanged_selects_none"
+  assert_jsonl_not_contains '"type":"probe_ran"' "affected_unchanged_runs_nothing"
+  end_case test_affected
+}
+
+test_build_trace() {
+  should_run build_trace || return 0
+  begin_case build_trace
+  local work_dir trace_file durations_file
+  prepare_work_dir
+  work_dir="${LAST_WORK_DIR}"
+  trace_file="${work_dir}/build-trace.json"
+  durations_file="${work_dir}/${BUILD_DIR}/cache/compile-durations.txt"
+
+  run_cb_build "${work_dir}" --trace="${trace_file}"
+  assert_file_exists "${trace_file}" "trace_written"
+  assert_text_contains "$(cat "${trace_file}")" '"traceEvents":[' "trace_event_array"
+  assert_text_contains "$(cat "${trace_file}")" '"cat":"compile"' "trace_compile_span"
+  assert_text_contains "$(cat "${trace_file}")" '"cat":"link"' "trace_link_span"
+  assert_text_contains "$(cat "${trace_file}")" '"args":{"name":"worker 1"}' "trace_worker_lane"
+  assert_text_contains "$(cat "${trace_file}")" '"name":"build","cat":"phase"' "trace_build_phase"
+  # The JSONL stream is still the selected observer; the trace is beside it.
+  assert_jsonl_contains '"type":"build_end"' "jsonl_still_written"
+
+  assert_file_exists "${durations_file}" "compile_durations_recorded"
+  assert_text_contains "$(cat "${durations_file}")" 'hello.c++' "compile_durations_unit"
+  end_case build_trace
+}
+
+test_content_digest() {
+  should_run content_digest || return 0
+  begin_case content_digest
+  local work_dir
+  prepare_work_dir
+  work_dir="${LAST_WORK_DIR}"
+
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_file_exists "${work_dir}/${BUILD_DIR}/cache/content-digests.txt" "digests_recorded"
+
+  touch "${work_dir}/hello.c++"
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_compile_end "hello.c++" true "" true "touched_source_cut_off"
+
+  printf '%s\n' '// comment-only edit' >> "${work_dir}/hello.c++"
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_compile_end "hello.c++" true "" true "comment_edit_cut_off"
+
+  # The default basis reads the same cache and stays conservative.
+  run_cb_build "${work_dir}"
+  assert_compile_end "hello.c++" false source_stale true "mtime_still_rebuilds"
+  # That build recorded the object without a digest; a digest build with nothing to compile
+  # digests it, so the edit below is compared with the text that object was built from.
+  run_cb_build "${work_dir}" --freshness=digest
+
+  printf '%s\n' 'int cb_smoke_digest_probe = 1;' >> "${work_dir}/hello.c++"
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_compile_end "hello.c++" false source_changed true "code_edit_rebuilds"
+  assert_rebuild_summary source_changed 1 "" "code_edit_summary"
+  end_case content_digest
+}
+
+test_content_digest_modules() {
+  should_run content_digest_modules || return 0
+  begin_case content_digest_modules
+  local work_dir
+  prepare_work_dir
+  work_dir="${LAST_WORK_DIR}"
+
+  printf '%s\n' 'export module greet;' 'export int greet() { return 1; }' 'export int farewell();' \
+    > "${work_dir}/greet.c++m"
+  printf '%s\n' 'module greet;' 'int farewell() { return 2; }' > "${work_dir}/greet.impl.c++"
+  printf '%s\n' 'import greet;' 'int main() { return greet() + farewell() - 3; }' > "${work_dir}/hello.c++"
+
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_file_exists "${work_dir}/${BUILD_DIR}/cache/content-digests.txt" "module_digests_recorded"
+
+  # A comment on the interface: the source cutoff stops it before the compiler, so neither
+  # the interface, its implementation unit nor its importer is rebuilt.
+  printf '%s\n' '// comment-only edit' >> "${work_dir}/greet.c++m"
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_compile_end "greet.c++m" true "" true "interface_comment_cut_off"
+  assert_compile_end "greet.impl.c++" true "" true "interface_comment_spares_implementation"
+  assert_compile_end "hello.c++" true "" true "interface_comment_spares_importer"
+
+  # A body in the implementation unit: that unit alone, since it writes no BMI.
+  printf '%s\n' 'module greet;' 'int farewell() { return 3 - 1; }' > "${work_dir}/greet.impl.c++"
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_compile_end "greet.impl.c++" false source_changed true "implementation_body_rebuilds"
+  assert_compile_end "greet.c++m" true "" true "implementation_body_spares_interface"
+  assert_compile_end "hello.c++" true "" true "implementation_body_spares_importer"
+
+  # A body in the interface reaches the compiler, and Clang's BMI carries that body and the
+  # source's size, so the BMI's bytes change and the importers follow it (docs/cb.md).
+  printf '%s\n' 'export module greet;' 'export int greet() { return 0; }' 'export int farewell();' \
+    > "${work_dir}/greet.c++m"
+  run_cb_build "${work_dir}" --freshness=digest
+  assert_compile_end "greet.c++m" false source_changed true "interface_body_rebuilds"
+  assert_compile_end "hello.c++" false bmi_changed true "interface_body_importer_bmi_changed"
+  assert_rebuild_summary bmi_changed 1 "" "interface_body_summary"
+  end_case content_digest_modules
+}
+
 test_test_runner_exact_name() {
   should_run test_runner_exact_name || return 0
   begin_case test_runner_exact_name
@@ -2169,6 +2336,10 @@ main() {
   test_deps_package_tests_skipped
   test_rebuild_summary
   test_test_lifecycle
+  test_test_affected
+  test_build_trace
+  test_content_digest
+  test_content_digest_modules
   test_test_runner_exact_name
   test_cache_invalidate
   test_profile_change
@@ -17,6 +17,11 @@
 #   ./tools/bench-cb-vs-ninja.sh --quiet-ninja          # default Ninja progress
 #   ./tools/bench-cb-vs-ninja.sh --jobs=4 --cold=2
 #   ./tools/bench-cb-vs-ninja.sh --results=/tmp/out.jsonl
+#   ./tools/bench-cb-vs-ninja.sh --cb-only --critical-path  # wall time vs lower bound
+#
+# --critical-path traces each CB cold build (--trace=) and reports, next to its wall
+# time, the longest weighted path through the module graph and total work / jobs: no
+# scheduler can beat the larger of the two, so the gap is parallelism left unused.
 #
 # Parses stdout of this script for a human summary; machine rows are JSONL on
 # the results file (and echoed). Exit 0 on success.
@@ -35,6 +40,7 @@ NOOP_N=5
 TOUCH_N=3
 NINJA_VERBOSE=1
 RUN_NINJA=1
+CRITICAL_PATH=0
 MODULES=two-phase
 RESULTS="${TMPDIR:-/tmp}/cb-vs-ninja-bench.jsonl"
 CONFIG=debug
@@ -46,7 +52,7 @@ TOUCH_TEST="${TOUCH_TEST:-tester/tester-assertions.test.c++}"
 TOUCH_MOD="${TOUCH_MOD:-tester/tester-assertions.c++m}"
 
 usage() {
-  sed -n '2,22p' "$0" | sed 's/^# \{0,1\}//'
+  sed -n '2,27p' "$0" | sed 's/^# \{0,1\}//'
   exit "${1:-0}"
 }
 
@@ -54,6 +60,7 @@ for arg in "$@"; do
   case "$arg" in
     -h|--help) usage 0 ;;
     --cb-only) RUN_NINJA=0 ;;
+    --critical-path) CRITICAL_PATH=1 ;;
     --quiet-ninja) NINJA_VERBOSE=0 ;;
     --verbose-ninja) NINJA_VERBOSE=1 ;;
     --modules=one-phase|--modules=two-phase) MODULES="${arg#*=}" ;;
@@ -199,6 +206,86 @@ assert "profile_change" not in rs, f"unexpected profile_change: {rs}"
 PY
 }
 
+# Lower bounds for one traced CB build. The graph comes from `cb list` unit events; step
+# durations from the trace, by unit path. Under two-phase an interface's importers wait for
+# its BMI only, so the path through it counts the precompile and runs the object beside them.
+report_critical_path() {
+  local label="$1"
+  local trace="$2"
+  python3 - "$label" "$trace" "$TRACE_DIR/units.jsonl" "$JOBS" <<'PY' | tee -a "$RESULTS"
+import json, sys
+from collections import defaultdict
+from functools import lru_cache
+
+label, trace_path, units_path, jobs = sys.argv[1], sys.argv[2], sys.argv[3], int(sys.argv[4])
+spans = [e for e in json.load(open(trace_path))["traceEvents"] if e.get("ph") == "X"]
+
+units = {}
+for line in open(units_path):
+    try:
+        o = json.loads(line)
+    except json.JSONDecodeError:
+        continue
+    if o.get("type") == "unit":
+        units[o["path"]] = o
+path_of = {u["unit"]: p for p, u in units.items()}
+
+precompile = defaultdict(int)
+compile_ = defaultdict(int)
+link = 0
+wall = 0
+outside = defaultdict(int)  # the std module: every unit imports it, so its BMI comes first
+work = 0
+for e in spans:
+    cat, name, dur = e.get("cat"), e.get("name"), e.get("dur", 0)
+    if cat == "phase":
+        if name == "build":
+            wall = dur
+        continue
+    if cat not in ("precompile", "compile", "link"):
+        continue
+    work += dur
+    if cat == "link":
+        link = max(link, dur)
+    elif name not in units:
+        outside[cat] += dur
+    elif cat == "precompile":
+        precompile[name] += dur
+    else:
+        compile_[name] += dur
+
+def providers(path):
+    u = units[path]
+    keys = list(u.get("imports", []))
+    if u.get("kind") == "implementation" and u.get("module"):
+        keys.append(u["module"])
+    return [path_of[k] for k in keys if k in path_of]
+
+@lru_cache(maxsize=None)
+def published(path):
+    own = precompile[path] if precompile[path] else compile_[path]
+    return max((published(p) for p in providers(path)), default=0) + own
+
+def finished(path):
+    tail = compile_[path] if precompile[path] else 0
+    return published(path) + tail
+
+sys.setrecursionlimit(10000)
+prefix = outside["precompile"] or outside["compile"]
+critical = prefix + max((finished(p) for p in units), default=0) + link
+bound = max(critical, work // max(jobs, 1))
+print(json.dumps({
+    "scenario": f"{label}_critical_path",
+    "wall_ms": wall // 1000,
+    "critical_path_ms": critical // 1000,
+    "work_ms": work // 1000,
+    "lower_bound_ms": bound // 1000,
+    "unused_ms": max(wall - bound, 0) // 1000,
+    "parallelism": round(work / wall, 2) if wall else None,
+}))
+PY
+}
+
 assert_cmake_ok() {
   [[ -x "$CMAKE_DIR/test_runner" ]]
   if grep -qE 'ninja: build stopped|FAILED:|CMake Error' /tmp/bench-cb-vs-ninja.err /tmp/bench-cb-vs-ninja.out 2>/dev/null; then
@@ -238,13 +325,27 @@ for line in sys.stdin:
         print("profile_match OK", profile, file=sys.stderr)
 '
 
+TRACE_DIR=""
+if [[ "$CRITICAL_PATH" == "1" ]]; then
+  TRACE_DIR="$(mktemp -d "${TMPDIR:-/tmp}/cb-critical-path.XXXXXX")"
+  cb_cmd "$CONFIG" list --jsonl=trace >"$TRACE_DIR/units.jsonl" 2>/dev/null
+fi
+
 echo "===== COLD FULL ($COLD_N x) =====" >&2
 for ((i = 1; i <= COLD_N; i++)); do
   echo "-- CB cold $i" >&2
   cb_cmd "$CONFIG" clean >/dev/null
-  run_timed "cb_cold_$i" cb_cmd "$CONFIG" build --jsonl=failures --jobs="$JOBS"
+  if [[ "$CRITICAL_PATH" == "1" ]]; then
+    run_timed "cb_cold_$i" cb_cmd "$CONFIG" build --jsonl=failures --jobs="$JOBS" \
+      --trace="$TRACE_DIR/cb_cold_$i.json"
+  else
+    run_timed "cb_cold_$i" cb_cmd "$CONFIG" build --jsonl=failures --jobs="$JOBS"
+  fi
   extract_cb_build_end "cb_cold_$i"
   assert_cb_ok
+  if [[ "$CRITICAL_PATH" == "1" ]]; then
+    report_critical_path "cb_cold_$i" "$TRACE_DIR/cb_cold_$i.json"
+  fi
 done
 
 if [[ "$RUN_NINJA" == "1" ]]; then
@@ -328,6 +429,14 @@ for r in rows:
     if m:
         groups[m.group(1)].append(r["ms"])
 
+critical = defaultdict(list)
+for line in open(path):
+    line = line.strip()
+    if line.startswith("{"):
+        o = json.loads(line)
+        if str(o.get("scenario", "")).endswith("_critical_path"):
+            critical[re.sub(r"_\d+_critical_path$", "", o["scenario"])].append(o)
+
 print(f"{'scenario':28} {'n':>3} {'mean_ms':>8} {'min':>8} {'max':>8}")
 for key in sorted(groups):
     xs = groups[key]
@@ -357,6 +466,14 @@ if meta.get("ninja_enabled", True):
 else:
     print("CB-only run; Ninja scenarios skipped.")
 
+for key in sorted(critical):
+    xs = critical[key]
+    wall = statistics.mean(x["wall_ms"] for x in xs)
+    path_ms = statistics.mean(x["critical_path_ms"] for x in xs)
+    bound = statistics.mean(x["lower_bound_ms"] for x in xs)
+    print(f"\n{key}: wall {wall:.0f} ms, critical path {path_ms:.0f} ms, "
+          f"lower bound {bound:.0f} ms ({wall / bound if bound else 0:.2f}x of the bound)")
+
 print(f"\nresults: {path}")
 if meta:
     print(
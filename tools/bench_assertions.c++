@@ -0,0 +1,111 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+// Passing-assertion throughput, with and without a sink that asks for passing detail.
+//
+// "counters" is what a quiet run pays: no observer wants a passing assertion described, so
+// check_* only updates the statistics. "detail" registers an observer that does, which is the
+// cost every assertion paid before events were built lazily and what --jsonl=trace and a
+// verbose console still pay. The ratio between the two rows is the point of the program.
+//
+//   bench_assertions [--iterations=N]
+
+import std;
+import tester;
+
+namespace {
+
+// Wants every event and does nothing with it, so the row measures building the event rather
+// than writing it anywhere.
+struct detail_sink final : tester::output::observer
+{
+    std::atomic<std::size_t> events{0};
+
+    void assertion(const tester::output::assertion_event&) override
+    {
+        events.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+struct workload
+{
+    std::string_view name;
+    std::function<void(std::size_t)> body;
+};
+
+auto assertions_per_second(std::size_t iterations, const workload& work)
+{
+    const auto started = std::chrono::steady_clock::now();
+    for(auto i = std::size_t{0}; i < iterations; ++i)
+        work.body(i);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+    return elapsed.count() > 0.0 ? static_cast<double>(iterations) / elapsed.count() : 0.0;
+}
+
+std::optional<std::size_t> parse_count(std::string_view text)
+{
+    auto value = std::size_t{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if(error != std::errc{} or end != text.data() + text.size())
+        return std::nullopt;
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    using namespace tester::assertions;
+
+    auto iterations = std::size_t{2'000'000};
+    for(std::string_view option : std::span(argv, argc).subspan(1))
+    {
+        if(option.starts_with("--iterations="))
+        {
+            if(auto parsed = parse_count(option.substr(std::string_view{"--iterations="}.size())); parsed and *parsed > 0)
+            {
+                iterations = *parsed;
+                continue;
+            }
+        }
+        std::clog << "usage: bench_assertions [--iterations=N]\n";
+        return 1;
+    }
+
+    // The matchers count into whichever context is active, exactly as under test_runner.
+    auto context = tester::data::execution_context{};
+    const auto scope = tester::data::execution_scope{context};
+
+    const auto text = std::string{"the quick brown fox jumps over the lazy dog"};
+    const auto numbers = std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8};
+
+    const auto workloads = std::array{
+        workload{"check_eq(int, int)", [](std::size_t i){ check_eq(i, i); }},
+        workload{"check_eq(string, string)", [&](std::size_t){ check_eq(text, text); }},
+        workload{"check_contains(string, literal)", [&](std::size_t){ check_contains(text, "lazy"); }},
+        workload{"check_container_eq(vector<int>)", [&](std::size_t){ check_container_eq(numbers, numbers); }},
+    };
+
+    static auto sink = detail_sink{};
+    std::cout << std::format("{:<36}{:>16}{:>16}{:>10}\n", "assertion", "counters/s", "detail/s", "speedup");
+    for(const auto& work : workloads)
+    {
+        tester::output::clear_observers();
+        const auto counters = assertions_per_second(iterations, work);
+
+        tester::output::observe(sink);
+        const auto detail = assertions_per_second(iterations, work);
+        tester::output::unobserve(sink);
+
+        std::cout << std::format("{:<36}{:>16.0f}{:>16.0f}{:>9.1f}x\n",
+            work.name, counters, detail, detail > 0.0 ? counters / detail : 0.0);
+    }
+
+    const auto& stats = context.statistics;
+    const auto total = stats.total_assertions.load(std::memory_order_relaxed);
+    const auto ok = stats.successful_assertions.load(std::memory_order_relaxed);
+    std::cout << std::format("assertions: {}/{} passed, detail events: {}\n",
+        ok, total, sink.events.load(std::memory_order_relaxed));
+    return ok == total ? 0 : 1;
+}
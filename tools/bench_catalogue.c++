@@ -0,0 +1,137 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+// Catalogue cost per case: what a generated suite pays before its first test runs.
+//
+// Registers --cases test_cases the way a parameter suite does, each with one of --tags
+// bracket tags and an id, and every tenth depending on the case before it so the ordering
+// has something to move. Then it times what test_runner does with the catalogue: --list under
+// a literal tag filter and under a regex, the dependency grouping --shard and --processes
+// hand out, and a run whose filter matches nothing — which is the dependency sort and one
+// pass over the catalogue, without any test bodies. Each row is nanoseconds per registered
+// case, so suites of different sizes compare directly.
+//
+//   bench_catalogue [--cases=N] [--tags=N]
+
+import std;
+import tester;
+
+namespace {
+
+// Counts what --list matched, so a filter that quietly matched nothing shows.
+struct catalogue_sink final : tester::output::observer
+{
+    std::size_t matched = 0;
+
+    void test_catalogue(const tester::output::catalogue& tests) override
+    {
+        matched = tests.matched.size();
+    }
+};
+
+struct settings
+{
+    std::size_t cases = 100'000;
+    std::size_t tags = 16;
+};
+
+template<typename Work>
+double seconds_for(Work&& work)
+{
+    const auto started = std::chrono::steady_clock::now();
+    work();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void register_cases(const settings& config)
+{
+    using tester::basic::test_case;
+    using tester::basic::test_order;
+
+    for(auto i = std::size_t{0}; i < config.cases; ++i)
+    {
+        auto order = test_order{.priority = 0, .depends_on = {}, .id = std::format("generated_{}", i)};
+        if(i % 10 == 9)
+            order.depends_on.push_back(std::format("generated_{}", i - 1));
+        test_case(std::format("test_case [generated][t{}] case {}", i % config.tags, i), order) = []{};
+    }
+}
+
+std::optional<std::size_t> parse_count(std::string_view text)
+{
+    auto value = std::size_t{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if(error != std::errc{} or end != text.data() + text.size())
+        return std::nullopt;
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto config = settings{};
+    for(std::string_view option : std::span(argv, argc).subspan(1))
+    {
+        const auto take = [&](std::string_view prefix, std::size_t& target)
+        {
+            if(not option.starts_with(prefix))
+                return false;
+            const auto parsed = parse_count(option.substr(prefix.size()));
+            if(not parsed or *parsed == 0)
+                return false;
+            target = *parsed;
+            return true;
+        };
+        if(take("--cases=", config.cases) or take("--tags=", config.tags))
+            continue;
+        std::clog << "usage: bench_catalogue [--cases=N] [--tags=N]\n";
+        return 1;
+    }
+
+    auto sink = catalogue_sink{};
+    tester::output::clear_observers();
+    tester::output::observe(sink);
+
+    const auto per_case = [&](double seconds){ return seconds * 1e9 / static_cast<double>(config.cases); };
+    auto consistent = true;
+
+    std::cout << std::format("{} cases, {} tags\n", config.cases, config.tags);
+    std::cout << std::format("{:<22}{:>14}{:>12}{:>12}\n", "phase", "ns/case", "ms", "matched");
+    const auto row = [&](std::string_view phase, double seconds, std::optional<std::size_t> matched)
+    {
+        std::cout << std::format("{:<22}{:>14.1f}{:>12.1f}{:>12}\n",
+            phase, per_case(seconds), seconds * 1e3, matched ? std::to_string(*matched) : std::string{"-"});
+    };
+
+    row("register", seconds_for([&]{ register_cases(config); }), std::nullopt);
+
+    // Every --tags-th case carries [t0], starting with the first.
+    const auto tagged = config.cases / config.tags + (config.cases % config.tags != 0 ? 1 : 0);
+    const auto list = [&](std::string_view phase, std::string_view filter, std::size_t expected)
+    {
+        auto runner = tester::runner{filter};
+        const auto seconds = seconds_for([&]{ runner.list_tests(); });
+        row(phase, seconds, sink.matched);
+        consistent = consistent and sink.matched == expected;
+    };
+    list("list", "", config.cases);
+    list("list --tags=[t0]", "[t0]", tagged);
+    list("list --tags=[a][b]", "[generated][t0]", tagged);
+    const auto leading_one = static_cast<std::size_t>(std::ranges::count_if(std::views::iota(0uz, config.cases),
+        [](std::size_t i){ return std::to_string(i).starts_with('1'); }));
+    list("list --tags=<regex>", "case 1[0-9]*$", leading_one);
+
+    auto groups = std::size_t{0};
+    const auto grouping = seconds_for([&]{ groups = tester::runner{}.runnable_groups().size(); });
+    row("dependency groups", grouping, groups);
+
+    // Last: a run consumes the catalogue, whether or not its cases pass the filter.
+    row("sort + filtered run", seconds_for([&]{ tester::runner{"[no-such-tag]"}.run_tests(); }), std::nullopt);
+
+    tester::output::unobserve(sink);
+    if(not consistent)
+        std::clog << "bench_catalogue: a filter matched a different number of cases than it should\n";
+    return consistent ? 0 : 1;
+}
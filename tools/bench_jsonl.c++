@@ -0,0 +1,177 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+// JSONL trace throughput: a million assertion_passed events through the tester's JSONL observer,
+// once under each --jsonl-flush policy.
+//
+// Each of --threads workers reports its share as tests of --per-test assertions with a test
+// boundary after each, which is the shape --jsonl=trace --jobs=N writes. The stream counts what
+// reaches it and discards it, so a row measures encoding, handing lines off and writing them —
+// not the disk. "event" is what every run paid before lines were buffered: one flushed write
+// per line, one at a time. The flushes column is how many times the stream was asked to write.
+//
+//   bench_jsonl [--events=N] [--threads=N] [--per-test=N]
+
+import std;
+import tester;
+
+namespace {
+
+using tester::output::jsonl::flush_policy;
+
+// Counts bytes and flushes. Only the sink writes to it, under its own lock.
+class counting_buffer final : public std::streambuf
+{
+public:
+    std::size_t bytes() const { return m_bytes; }
+    std::size_t flushes() const { return m_flushes; }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if(not traits_type::eq_int_type(ch, traits_type::eof()))
+            ++m_bytes;
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char_type*, std::streamsize count) override
+    {
+        m_bytes += static_cast<std::size_t>(count);
+        return count;
+    }
+
+    int sync() override
+    {
+        ++m_flushes;
+        return 0;
+    }
+
+private:
+    std::size_t m_bytes = 0;
+    std::size_t m_flushes = 0;
+};
+
+struct settings
+{
+    std::size_t events = 1'000'000;
+    std::size_t threads = 4;
+    std::size_t per_test = 100;
+};
+
+struct outcome
+{
+    double seconds = 0.0;
+    std::size_t bytes = 0;
+    std::size_t flushes = 0;
+};
+
+outcome emit(flush_policy policy, const settings& config)
+{
+    auto counted = counting_buffer{};
+    auto stream = std::ostream{&counted};
+    auto discarded = std::ostream{nullptr};
+    auto observer = tester::output::jsonl::observer{stream, discarded, tester::output::jsonl::jsonl_mode::trace, 16384, policy};
+    observer.activate();
+
+    const auto started = std::chrono::steady_clock::now();
+    {
+        auto workers = std::vector<std::jthread>{};
+        for(auto worker = std::size_t{0}; worker < config.threads; ++worker)
+        {
+            workers.emplace_back([&, worker]{
+                const auto id = std::format("bench_jsonl -> worker {}", worker);
+                const auto event = tester::output::assertion_event{
+                    .ok = true,
+                    .matcher = "check_eq",
+                    .display_matcher = "check_eq",
+                    .actual = {.display = "42", .value = "42", .kind = tester::output::value_kind::number},
+                    .expected = {.display = "42", .value = "42", .kind = tester::output::value_kind::number},
+                    .message = {},
+                    .test_id = id,
+                    .file = "tools/bench_jsonl.c++",
+                    .line = 42,
+                    .column = 9};
+                const auto result = tester::data::test_result{tester::data::test_metadata{
+                    "bench_jsonl", std::format("worker {}", worker), "tools/bench_jsonl.c++", 42, 9, "", id}};
+
+                const auto share = config.events / config.threads + (worker < config.events % config.threads ? 1 : 0);
+                for(auto i = std::size_t{0}; i < share; ++i)
+                {
+                    observer.assertion(event);
+                    if((i + 1) % config.per_test == 0)
+                        observer.test_case_end(result);
+                }
+                observer.test_case_end(result);
+            });
+        }
+    }
+    observer.eof();
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+
+    return {.seconds = elapsed.count(), .bytes = counted.bytes(), .flushes = counted.flushes()};
+}
+
+std::optional<std::size_t> parse_count(std::string_view text)
+{
+    auto value = std::size_t{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if(error != std::errc{} or end != text.data() + text.size())
+        return std::nullopt;
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto config = settings{};
+    for(std::string_view option : std::span(argv, argc).subspan(1))
+    {
+        const auto take = [&](std::string_view prefix, std::size_t& target)
+        {
+            if(not option.starts_with(prefix))
+                return false;
+            const auto parsed = parse_count(option.substr(prefix.size()));
+            if(not parsed or *parsed == 0)
+                return false;
+            target = *parsed;
+            return true;
+        };
+        if(take("--events=", config.events) or take("--threads=", config.threads) or take("--per-test=", config.per_test))
+            continue;
+        std::clog << "usage: bench_jsonl [--events=N] [--threads=N] [--per-test=N]\n";
+        return 1;
+    }
+
+    constexpr auto policies = std::array{
+        std::pair{flush_policy::event, "event"},
+        std::pair{flush_policy::test, "test"},
+        std::pair{flush_policy::batch, "batch"},
+    };
+
+    std::cout << std::format("{} events, {} threads, {} per test\n", config.events, config.threads, config.per_test);
+    std::cout << std::format("{:<10}{:>16}{:>12}{:>12}{:>10}\n", "flush", "events/s", "MB/s", "flushes", "speedup");
+    auto baseline = 0.0;
+    auto bytes = std::optional<std::size_t>{};
+    auto consistent = true;
+    for(const auto& [policy, name] : policies)
+    {
+        const auto measured = emit(policy, config);
+        const auto rate = measured.seconds > 0.0 ? static_cast<double>(config.events) / measured.seconds : 0.0;
+        if(policy == flush_policy::event)
+            baseline = rate;
+        std::cout << std::format("{:<10}{:>16.0f}{:>12.1f}{:>12}{:>9.1f}x\n",
+            name, rate, static_cast<double>(measured.bytes) / 1e6 / std::max(measured.seconds, 1e-9),
+            measured.flushes, baseline > 0.0 ? rate / baseline : 0.0);
+
+        // Every policy writes the same lines, give or take the digits of a timestamp, so a
+        // policy that lost some would show here as a stream far shorter than the others.
+        if(bytes.has_value() and measured.bytes + measured.bytes / 100 < *bytes)
+            consistent = false;
+        bytes = std::max(bytes.value_or(0), measured.bytes);
+    }
+    if(not consistent)
+        std::clog << "bench_jsonl: a policy wrote noticeably fewer bytes than another\n";
+    return consistent ? 0 : 1;
+}
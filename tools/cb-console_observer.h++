@@ -212,6 +212,19 @@ struct observer final : cb::output::observer
             warning(step.diag.head);
     }
 
+    void test_selection(const test_selection& selection) override
+    {
+        if(not selection.fallback.empty())
+        {
+            info("Running all tests: " + std::string{selection.fallback});
+            return;
+        }
+        info("Running " + std::to_string(selection.selected) + " of " + std::to_string(selection.total)
+             + " tests affected by " + std::to_string(selection.changed_units.size()) + " changed unit(s)");
+        if(not selection.changed_units.empty())
+            info("  changed: " + (selection.changed_units | std::views::join_with(", "sv) | std::ranges::to<std::string>()));
+    }
+
     // A passing run says so here rather than in the command, for the same reason the skipped-link
     // line does. A failing one is not ours alone to say: it goes out as `error`, which the JSONL
     // stream writes as cb_error, so test_scope raises it and this observer prints it like any other.
@@ -305,6 +305,19 @@ struct observer final : cb::output::observer
         };
     }
 
+    void test_selection(const test_selection& selection) override
+    {
+        auto lock = std::lock_guard<std::mutex>{m.mutex};
+        m.json << m.jsonl("test_selection") << [&](std::ostream& os){
+            write_string_array(os, "changed_units", selection.changed_units);
+            os << ",\"full_run\":" << (selection.fallback.empty() ? "false" : "true");
+            if(not selection.fallback.empty())
+                os << ",\"fallback\":\"" << escape(selection.fallback) << "\"";
+            os << ",\"selected\":" << selection.selected;
+            os << ",\"total\":" << selection.total;
+        };
+    }
+
     void test_start(std::string_view runner) override
     {
         auto lock = std::lock_guard<std::mutex>{m.mutex};
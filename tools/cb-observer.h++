@@ -140,6 +140,7 @@ enum class rebuild_kind
     none,
     not_in_cache,
     source_stale,
+    source_changed,
     header_stale,
     header_missing,
     depfile_unusable,
@@ -149,6 +150,7 @@ enum class rebuild_kind
     own_bmi_stale,
     bmi_stale,
     dependency_bmi_stale,
+    bmi_changed,
     profile_change,
     missing_executable,
     object_changed,
@@ -163,6 +165,7 @@ constexpr std::string_view rebuild_kind_name(rebuild_kind kind)
         case rebuild_kind::none: return {};
         case rebuild_kind::not_in_cache: return "not_in_cache";
         case rebuild_kind::source_stale: return "source_stale";
+        case rebuild_kind::source_changed: return "source_changed";
         case rebuild_kind::header_stale: return "header_stale";
         case rebuild_kind::header_missing: return "header_missing";
         case rebuild_kind::depfile_unusable: return "depfile_unusable";
@@ -172,6 +175,7 @@ constexpr std::string_view rebuild_kind_name(rebuild_kind kind)
         case rebuild_kind::own_bmi_stale: return "own_bmi_stale";
         case rebuild_kind::bmi_stale: return "bmi_stale";
         case rebuild_kind::dependency_bmi_stale: return "dependency_bmi_stale";
+        case rebuild_kind::bmi_changed: return "bmi_changed";
         case rebuild_kind::profile_change: return "profile_change";
         case rebuild_kind::missing_executable: return "missing_executable";
         case rebuild_kind::object_changed: return "object_changed";
@@ -193,6 +197,8 @@ constexpr std::string_view rebuild_hint(rebuild_kind kind)
             return "Source path not present in object cache for this config.";
         case rebuild_kind::source_stale:
             return "Source mtime newer than cached compile timestamp.";
+        case rebuild_kind::source_changed:
+            return "Source content digest differs from the one last compiled (--freshness=digest).";
         case rebuild_kind::header_stale:
             return "An included header is newer than this object (from the compiler depfile).";
         case rebuild_kind::header_missing:
@@ -211,6 +217,8 @@ constexpr std::string_view rebuild_hint(rebuild_kind kind)
             return "Imported BMI newer than this object; recompile follows module graph.";
         case rebuild_kind::dependency_bmi_stale:
             return "Imported module BMI is missing or older than its source.";
+        case rebuild_kind::bmi_changed:
+            return "Imported BMI content changed since this object was built (--freshness=digest).";
         case rebuild_kind::profile_change:
             return "Object-cache toolchain profile changed; see profile_changed event.";
         case rebuild_kind::missing_executable:
@@ -294,6 +302,8 @@ inline std::string compile_rebuild_message(const compile_unit& unit, const rebui
             if(not info.trigger_path.empty() and info.trigger_path != unit.source)
                 return "Rebuilding " + label + " because dependency " + info.trigger_path + " is newer than its cached object";
             return "Rebuilding " + label + " because source is newer than the cached object";
+        case rebuild_kind::source_changed:
+            return "Rebuilding " + label + " because its source content changed";
         case rebuild_kind::header_stale:
             return "Rebuilding " + label + " because included header " + info.trigger_path + " is newer than its object";
         case rebuild_kind::header_missing:
@@ -304,6 +314,8 @@ inline std::string compile_rebuild_message(const compile_unit& unit, const rebui
             return "Rebuilding " + label + " because BMI " + info.module + " is newer than the object (import graph)";
         case rebuild_kind::dependency_bmi_stale:
             return "Rebuilding " + label + " because imported module " + info.module + " BMI is missing or stale";
+        case rebuild_kind::bmi_changed:
+            return "Rebuilding " + label + " because the content of BMI " + info.module + " changed";
         case rebuild_kind::object_missing:
             return "Rebuilding " + label + " because object file is missing";
         case rebuild_kind::object_stale:
@@ -395,6 +407,17 @@ struct cache_removals
     bool std_module_profile = false;
 };
 
+// What `test --affected` chose to run. A non-empty fallback names why the whole suite runs
+// instead — no earlier passing run to compare with, a change no import edge can scope — because
+// "ran everything" and "everything was affected" look the same in a count and are not.
+struct test_selection
+{
+    std::span<const std::string> changed_units{};
+    std::string_view fallback{};
+    std::size_t selected = 0;
+    std::size_t total = 0;
+};
+
 class observer
 {
 public:
@@ -424,6 +447,8 @@ public:
 
     virtual void build_end(bool /*ok*/, const interval& /*timing*/) {}
 
+    virtual void test_selection(const test_selection& /*selection*/) {}
+
     virtual void test_start(std::string_view /*runner*/) {}
 
     virtual void test_end(const process_result& /*result*/, const interval& /*timing*/) {}
@@ -0,0 +1,186 @@
+// Copyright (c) 2025-2026 Kaius Ruokonen. All rights reserved.
+// SPDX-License-Identifier: MIT
+// See the LICENSE file in the project root for full license text.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <flat_map>
+#include <fstream>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../tester/details/jsonl.h++"
+#include "cb-observer.h++"
+
+namespace cb::output::trace {
+
+using ::jsonl::escape_to;
+
+// `--trace=<path>`: every clang and linker process as a span in Chrome's trace-event format, one
+// lane per thread that ran it, plus the build and test phases on a lane of their own. Open it in
+// chrome://tracing or ui.perfetto.dev. Additive, like the runner's --junit: it sits beside the
+// console or JSONL observer rather than replacing it, and writes its file once, at finish.
+//
+// Built from command_end rather than compile_end because a two-phase unit is two processes that
+// may run on two workers with other units between them — which is the thing a trace is for. The
+// compile events only lend each process a readable name: the unit whose BMI or object it writes.
+class observer final : public cb::output::observer
+{
+public:
+    void configure(std::string path)
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        output_path = std::move(path);
+    }
+
+    void activate() override
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        origin = std::chrono::steady_clock::now();
+        spans.clear();
+        lanes.clear();
+        unit_of_output.clear();
+    }
+
+    void finish() override
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        if(output_path.empty())
+            return;
+
+        auto file = std::ofstream{output_path, std::ios::trunc};
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"cb"}})";
+        file << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"phases"}})";
+        for(auto lane = std::size_t{1}; lane <= lanes.size(); ++lane)
+            file << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << lane
+                 << R"(,"args":{"name":"worker )" << lane << "\"}}";
+        for(const auto& span : spans)
+        {
+            file << ",\n{\"name\":\"";
+            escape_to(file, span.name);
+            file << "\",\"cat\":\"" << span.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.lane
+                 << ",\"ts\":" << span.ts_us << ",\"dur\":" << span.dur_us
+                 << ",\"args\":{\"ok\":" << (span.ok ? "true" : "false");
+            if(not span.output.empty())
+            {
+                file << ",\"output\":\"";
+                escape_to(file, span.output);
+                file << '"';
+            }
+            file << "}}";
+        }
+        file << "\n]}\n";
+    }
+
+    void compile_start(const compile_unit& unit, const rebuild_info&) override
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        if(not unit.object.empty())
+            unit_of_output.insert_or_assign(std::string{unit.object}, std::string{unit.display_path});
+        if(not unit.bmi.empty())
+            unit_of_output.insert_or_assign(std::string{unit.bmi}, std::string{unit.display_path});
+    }
+
+    void command_end(std::string_view,
+                     std::span<const std::string> argv,
+                     const process_result& result,
+                     const interval& timing) override
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        const auto output = output_of(argv);
+        const auto named = unit_of_output.find(output);
+        auto name = named != unit_of_output.end()
+            ? named->second
+            : not output.empty() ? std::string{output}
+            : argv.empty() ? std::string{} : argv.front();
+        add(std::move(name), category_of(argv, output), std::string{output}, lane_of_this_thread(), result.ok(), timing);
+    }
+
+    void build_end(bool ok, const interval& timing) override
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        add("build", "phase", {}, 0, ok, timing);
+    }
+
+    void test_end(const process_result& result, const interval& timing) override
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex};
+        add("test", "phase", {}, 0, result.ok(), timing);
+    }
+
+private:
+    struct span
+    {
+        std::string name;
+        std::string_view category;
+        std::string output;
+        std::size_t lane = 0;
+        bool ok = false;
+        std::chrono::microseconds::rep ts_us = 0;
+        std::chrono::microseconds::rep dur_us = 0;
+    };
+
+    static std::string_view output_of(std::span<const std::string> argv)
+    {
+        const auto flag = std::ranges::find(argv, std::string_view{"-o"});
+        if(flag == argv.end() or std::next(flag) == argv.end())
+            return {};
+        return *std::next(flag);
+    }
+
+    // What the process did, by the flags that decide it: --precompile writes a BMI, -c an
+    // object, and any other -o is a link. A command with no output — a version probe, the test
+    // runner — is still on the timeline, just not as a build step.
+    static std::string_view category_of(std::span<const std::string> argv, std::string_view output)
+    {
+        if(std::ranges::contains(argv, std::string_view{"--precompile"}))
+            return "precompile";
+        if(std::ranges::contains(argv, std::string_view{"-c"}))
+            return "compile";
+        if(not output.empty())
+            return "link";
+        return "command";
+    }
+
+    // Lanes are numbered in the order threads first report, from 1; 0 is the phase lane.
+    std::size_t lane_of_this_thread()
+    {
+        const auto id = std::this_thread::get_id();
+        if(const auto found = lanes.find(id); found != lanes.end())
+            return found->second;
+        const auto lane = lanes.size() + 1;
+        lanes.emplace(id, lane);
+        return lane;
+    }
+
+    void add(std::string name, std::string_view category, std::string output,
+             std::size_t lane, bool ok, const interval& timing)
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        spans.push_back({.name = std::move(name),
+                         .category = category,
+                         .output = std::move(output),
+                         .lane = lane,
+                         .ok = ok,
+                         .ts_us = duration_cast<microseconds>(timing.started - origin).count(),
+                         .dur_us = duration_cast<microseconds>(timing.finished - timing.started).count()});
+    }
+
+    std::mutex mutex;
+    std::string output_path;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::vector<span> spans;
+    std::flat_map<std::thread::id, std::size_t> lanes;
+    std::flat_map<std::string, std::string, std::less<>> unit_of_output;
+};
+
+} // namespace cb::output::trace
@@ -49,6 +49,7 @@
 #include <type_traits>
 #include "cb-jsonl_observer.h++"
 #include "cb-console_observer.h++"
+#include "cb-trace_observer.h++"
 
 namespace fs = std::filesystem;
 
@@ -206,6 +207,34 @@ std::optional<fs::file_time_type> file_time(const fs::path& path)
     return stamp;
 }
 
+// FNV-1a: not a cryptographic digest, only a fingerprint that changes when the bytes do. Taking
+// the running value as the seed lets a caller fold a file through it a chunk at a time.
+inline constexpr auto content_hash_seed = std::uint64_t{14695981039346656037ULL};
+
+std::uint64_t content_hash(std::string_view bytes, std::uint64_t hash = content_hash_seed)
+{
+    constexpr auto prime = std::uint64_t{1099511628211ULL};
+    return std::ranges::fold_left(bytes, hash, [=](std::uint64_t value, char byte)
+    {
+        return (value ^ static_cast<unsigned char>(byte)) * prime;
+    });
+}
+
+// A BMI runs to megabytes, so it is read in chunks rather than into one string.
+std::optional<std::uint64_t> file_content_hash(const fs::path& path)
+{
+    auto file = std::ifstream{path, std::ios::binary};
+    if(not file)
+        return std::nullopt;
+    auto hash = content_hash_seed;
+    auto chunk = std::array<char, 64 * 1024>{};
+    while(file.read(chunk.data(), chunk.size()) or file.gcount() > 0)
+        hash = content_hash({chunk.data(), static_cast<std::size_t>(file.gcount())}, hash);
+    if(file.bad())
+        return std::nullopt;
+    return hash;
+}
+
 // A cache (or other stamped index) is replaced, never edited in place: write a sibling
 // temporary, then rename it over the target, so a build interrupted mid-write leaves the
 // previous file rather than half of the next. Callers differ only in what they write and
@@ -527,7 +556,32 @@ public:
             consider(tu.module);
     }
 
+    // --freshness=digest: what a source says once its comments are gone, so a touched file, or
+    // one whose comments alone changed, digests the same as the text its object was compiled
+    // from. Trailing whitespace goes too — no line follows it to move. Not spliced: a splice
+    // changes line numbers the compiler reports, so it should change the digest. nullopt when
+    // the file cannot be read, which the caller answers by compiling.
+    static std::optional<std::uint64_t> content_digest(const std::string& path)
+    {
+        auto file = std::ifstream{path, std::ios::binary};
+        if(not file)
+            return std::nullopt;
+        const auto text = std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        if(file.bad())
+            return std::nullopt;
+
+        auto stripped = strip_comments_and_literals(text, strip_mode::digest);
+        while(not stripped.empty() and std::isspace(static_cast<unsigned char>(stripped.back())) != 0)
+            stripped.pop_back();
+        return detail::content_hash(stripped);
+    }
+
 private:
+    enum class strip_mode : unsigned char
+    {
+        scan,   // import/module matching: comments and literal contents go
+        digest, // content freshness: comments go, everything the compiler reads stays
+    };
 
     // True for `dir` or `dir/...`.
     static bool is_dir_or_under(std::string_view path, std::string_view dir)
@@ -678,11 +732,17 @@ private:
     // which made it the single largest CPU cost of a build, cached or not. A construct is only
     // consumed once its closer is found, so an unterminated quote or `/*` is left as ordinary
     // text — the same answer the alternation gave by failing to match.
-    static std::string strip_comments_and_literals(std::string_view text)
+    //
+    // The digest mode walks the same constructs for --freshness=digest but keeps what the
+    // compiler would see: literals stay whole, a block comment keeps its newlines so no later
+    // line moves, and a `'` after a digit is a separator (`1'000`), not a character literal
+    // whose false closer could hide a real `"/*"` behind a comment.
+    static std::string strip_comments_and_literals(std::string_view text, strip_mode mode = strip_mode::scan)
     {
         // Comments collapse to a single space, since a comment separates tokens
         // (`import/*x*/foo`); a literal keeps its delimiters but loses contents that may spell
         // `import foo;`, which the unanchored matchers would otherwise find.
+        const auto digest = mode == strip_mode::digest;
         auto result = std::string{};
         result.reserve(text.size());
 
@@ -710,8 +770,10 @@ private:
                 const auto close = text.find("*/"sv, cursor + 2);
                 if(close != std::string_view::npos)
                 {
-                    cursor = close + 2;
                     result.push_back(' ');
+                    if(digest)
+                        result.append(static_cast<std::size_t>(std::ranges::count(text.substr(cursor, close - cursor), '\n')), '\n');
+                    cursor = close + 2;
                     continue;
                 }
             }
@@ -730,20 +792,30 @@ private:
                     if(const auto close = text.find(closer, delimiter_end + 1);
                        close != std::string_view::npos)
                     {
+                        if(digest)
+                            result.append(text.substr(cursor, close + closer.size() - cursor));
+                        else
+                            result.append(" \"\""sv);
                         cursor = close + closer.size();
-                        result.append(" \"\""sv);
                         continue;
                     }
                 }
             }
-            else if(character == '"' or character == '\'')
+            else if((character == '"' or character == '\'')
+                    and not (digest and character == '\'' and cursor > 0
+                             and std::isdigit(static_cast<unsigned char>(text[cursor - 1])) != 0))
             {
                 if(const auto close = quoted_end(text, cursor); close != std::string_view::npos)
                 {
+                    if(digest)
+                        result.append(text.substr(cursor, close - cursor));
+                    else
+                    {
+                        result.push_back(' ');
+                        result.push_back(character);
+                        result.push_back(character);
+                    }
                     cursor = close;
-                    result.push_back(' ');
-                    result.push_back(character);
-                    result.push_back(character);
                     continue;
                 }
             }
@@ -2155,12 +2227,7 @@ public:
     // profiles still less likely; a collision never bypasses the profile comparison.
     std::string key() const
     {
-        constexpr auto offset = std::uint64_t{14695981039346656037ULL};
-        constexpr auto prime = std::uint64_t{1099511628211ULL};
-        const auto hash = std::ranges::fold_left(text_, offset, [=](std::uint64_t value, char byte)
-        {
-            return (value ^ static_cast<unsigned char>(byte)) * prime;
-        });
+        const auto hash = detail::content_hash(text_);
         auto digits = std::array<char, 16>{};
         const auto converted = std::to_chars(digits.data(), digits.data() + digits.size(), hash, 16);
         return std::to_string(text_.size()) + '-' + std::string{digits.data(), converted.ptr};
@@ -2337,6 +2404,15 @@ public:
         return entries_.erase(source_path) != 0;
     }
 
+    // The source time a unit was last compiled at, from the loaded snapshot.
+    std::optional<fs::file_time_type> remembered(std::string_view source_path) const
+    {
+        const auto found = entries_.find(source_path);
+        if(found == entries_.end())
+            return std::nullopt;
+        return found->second;
+    }
+
     bool invalidate() const { return file_.invalidate(); }
 
     disk_status status(std::string_view current_profile) const
@@ -2930,6 +3006,391 @@ private:
     storage_file file_;
 };
 
+// How long each unit's last compile took, BMI and object phases apart. The scheduler weighs
+// ready work by it and `--trace` shows where it went; nothing decides freshness from it, so a
+// missing or stale file costs a worse start order on the next build and nothing else. A phase
+// that did not run this build — a cache hit, an object-only repair — keeps its last duration.
+class compile_duration_store
+{
+public:
+    struct phases
+    {
+        std::int64_t bmi_ms = 0;
+        std::int64_t object_ms = 0;
+    };
+
+    explicit compile_duration_store(std::string cache_dir)
+        : file_{std::move(cache_dir), filename}
+    {}
+
+    const std::string& path() const { return file_.path(); }
+
+    void load()
+    {
+        entries_.clear();
+        auto file = std::ifstream{file_.path()};
+        for(auto line = ""s; std::getline(file, line);)
+        {
+            auto fields = line | std::views::split('\t')
+                | std::views::transform([](auto field) { return std::string_view{field}; })
+                | std::ranges::to<std::vector>();
+            if(fields.size() != 3)
+                continue;
+            auto loaded = phases{};
+            const auto read = [](std::string_view text, std::int64_t& value) {
+                return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc{};
+            };
+            if(read(fields[1], loaded.bmi_ms) and read(fields[2], loaded.object_ms))
+                entries_.insert_or_assign(std::string{fields[0]}, loaded);
+        }
+    }
+
+    void save() const
+    {
+        file_.replace("compile durations", [&](std::ostream& file) {
+            for(const auto& [unit, recorded] : entries_)
+                file << unit << '\t' << recorded.bmi_ms << '\t' << recorded.object_ms << '\n';
+        });
+    }
+
+    // Loaded snapshot only — read before the workers start, as link_store::remembered is.
+    std::optional<phases> remembered(std::string_view unit) const
+    {
+        const auto found = entries_.find(unit);
+        if(found == entries_.end())
+            return std::nullopt;
+        return found->second;
+    }
+
+    // Parallel compile workers: lock, then record the step that just finished.
+    void remember(std::string_view unit, toolchain::compile_output output, std::chrono::milliseconds elapsed)
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex_};
+        auto& recorded = entries_[std::string{unit}];
+        (output == toolchain::compile_output::bmi ? recorded.bmi_ms : recorded.object_ms) = elapsed.count();
+    }
+
+private:
+    inline static constexpr auto filename = "compile-durations.txt"sv;
+
+    storage_file file_;
+    std::flat_map<std::string, phases, std::less<>> entries_{};
+    std::mutex mutex_{};
+};
+
+// What a unit's freshness is judged on. mtime is the default and needs no reads beyond a stat;
+// digest also reads touched sources and hashes every BMI CB writes, to stop rebuilds that
+// change no bytes the compiler reads.
+enum class freshness_basis : unsigned char
+{
+    mtime,
+    digest,
+};
+
+// --freshness=digest: what each source said when its object was compiled, and what each BMI
+// holds. A source newer than its object but digesting the same is not recompiled. A BMI rewritten
+// with the bytes it already had keeps the time its content last changed, and that is what
+// importers compare their objects against — so an edit that leaves an interface's BMI as it was
+// stops at that unit instead of rebuilding the graph above it.
+//
+// Every row is checked before it is trusted. A source's row names the compile it describes — the
+// source time the object cache recorded — and a BMI's row the time the file was hashed at, so
+// whatever an mtime build compiled or wrote since is judged by mtime rather than by a digest of
+// something else. For the same reason nothing here outlives the object cache: a unit missing
+// from that rebuilds whatever its digest says, so `cache invalidate` leaves this file alone.
+class content_digest_store
+{
+public:
+    explicit content_digest_store(std::string cache_dir)
+        : file_{std::move(cache_dir), filename}
+    {}
+
+    const std::string& path() const { return file_.path(); }
+
+    void load()
+    {
+        sources_.clear();
+        bmis_.clear();
+        auto file = std::ifstream{file_.path()};
+        for(auto line = ""s; std::getline(file, line);)
+        {
+            const auto fields = line | std::views::split('\t')
+                | std::views::transform([](auto field) { return std::string_view{field}; })
+                | std::ranges::to<std::vector>();
+            auto digest = std::uint64_t{};
+            auto compiled = fs::file_time_type{};
+            if(fields.size() == 4 and fields[0] == "source" and read_digest(fields[2], digest)
+               and read_time(fields[3], compiled))
+                sources_.insert_or_assign(std::string{fields[1]}, source_row{.digest = digest, .compiled = compiled});
+
+            auto changed = fs::file_time_type{};
+            auto stamped = fs::file_time_type{};
+            if(fields.size() == 5 and fields[0] == "bmi" and read_digest(fields[2], digest)
+               and read_time(fields[3], changed) and read_time(fields[4], stamped))
+                bmis_.insert_or_assign(std::string{fields[1]},
+                                       bmi_row{.digest = digest, .changed = changed, .stamped = stamped});
+        }
+    }
+
+    void save() const
+    {
+        file_.replace("content digests", [&](std::ostream& file) {
+            for(const auto& [source, row] : sources_)
+                file << "source\t" << source << '\t' << std::hex << row.digest << std::dec
+                     << '\t' << ticks(row.compiled) << '\n';
+            for(const auto& [bmi, row] : bmis_)
+                file << "bmi\t" << bmi << '\t' << std::hex << row.digest << std::dec
+                     << '\t' << ticks(row.changed) << '\t' << ticks(row.stamped) << '\n';
+        });
+    }
+
+    // The digest of the text the object cache's `compiled` entry was built from, if this store
+    // saw that compile. Loaded snapshot, and the compile workers' reads of it — sources are only
+    // remembered once they have joined.
+    std::optional<std::uint64_t> source_digest(std::string_view source, fs::file_time_type compiled) const
+    {
+        const auto found = sources_.find(source);
+        if(found == sources_.end() or found->second.compiled != compiled)
+            return std::nullopt;
+        return found->second.digest;
+    }
+
+    // nullopt forgets: a unit compiled from text that could not be digested must not keep the
+    // digest of the text before it, which a later revert would match.
+    void remember_source(const std::string& source, std::optional<std::uint64_t> digest, fs::file_time_type compiled)
+    {
+        if(digest)
+            sources_.insert_or_assign(source, source_row{.digest = *digest, .compiled = compiled});
+        else
+            sources_.erase(source);
+    }
+
+    // Parallel compile workers, as soon as a step writes the BMI and before its importers are
+    // released. `before` is the BMI's time ahead of that step: the old row only describes the
+    // old bytes if it was hashed at that time, and otherwise this is a change like any other.
+    void remember_bmi(const std::string& bmi, std::optional<fs::file_time_type> before)
+    {
+        const auto stamped = detail::file_time(bmi);
+        const auto digest = stamped ? detail::file_content_hash(bmi) : std::nullopt;
+        auto lock = std::lock_guard<std::mutex>{mutex_};
+        if(not digest)
+        {
+            bmis_.erase(bmi);
+            return;
+        }
+
+        auto changed = *stamped;
+        if(const auto found = bmis_.find(bmi);
+           found != bmis_.end() and before and found->second.stamped == *before and found->second.digest == *digest)
+            changed = found->second.changed;
+        bmis_.insert_or_assign(bmi, bmi_row{.digest = *digest, .changed = changed, .stamped = *stamped});
+    }
+
+    // A first row for a BMI that is fresh but was never hashed — the one mtime would use, so
+    // nothing changes now, but the next rewrite has something to compare with.
+    void seed_bmi(const std::string& bmi)
+    {
+        const auto on_disk = detail::file_time(bmi);
+        if(not on_disk or content_changed(bmi, *on_disk))
+            return;
+        remember_bmi(bmi, std::nullopt);
+    }
+
+    // When the BMI on disk last changed content, if its row describes that file; nullopt when
+    // there is no such row and the caller should fall back on the file's own time.
+    std::optional<fs::file_time_type> content_changed(std::string_view bmi, fs::file_time_type on_disk) const
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex_};
+        const auto found = bmis_.find(bmi);
+        if(found == bmis_.end() or found->second.stamped != on_disk)
+            return std::nullopt;
+        return found->second.changed;
+    }
+
+    // Rows for sources and BMIs the tree no longer has go at the next save.
+    void retain(const std::flat_set<std::string, std::less<>>& paths)
+    {
+        std::erase_if(sources_, [&](const auto& row) { return not paths.contains(row.first); });
+        std::erase_if(bmis_, [&](const auto& row) { return not paths.contains(row.first); });
+    }
+
+private:
+    struct source_row
+    {
+        std::uint64_t digest = 0;
+        fs::file_time_type compiled{};
+    };
+
+    struct bmi_row
+    {
+        std::uint64_t digest = 0;
+        fs::file_time_type changed{};
+        fs::file_time_type stamped{};
+    };
+
+    static long long ticks(fs::file_time_type time)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    static bool read_digest(std::string_view text, std::uint64_t& digest)
+    {
+        const auto parsed = std::from_chars(text.data(), text.data() + text.size(), digest, 16);
+        return parsed.ec == std::errc{} and parsed.ptr == text.data() + text.size();
+    }
+
+    static bool read_time(std::string_view text, fs::file_time_type& time)
+    {
+        auto value = 0ll;
+        const auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(parsed.ec != std::errc{} or parsed.ptr != text.data() + text.size())
+            return false;
+        time = fs::file_time_type{std::chrono::nanoseconds{value}};
+        return true;
+    }
+
+    inline static constexpr auto filename = "content-digests.txt"sv;
+
+    storage_file file_;
+    std::flat_map<std::string, source_row, std::less<>> sources_{};
+    std::flat_map<std::string, bmi_row, std::less<>> bmis_{};
+    mutable std::mutex mutex_{};
+};
+
+// What `test --affected` compares against. The baseline is every unit's object stamp as of the
+// last run that passed the whole suite; the catalogue is which test ids each unit contributes,
+// read from the runner's own `--list`. Separate files because they go stale for different
+// reasons — the baseline moves only on a passing run, the catalogue whenever the runner is
+// relinked — and refreshing the catalogue mid-way must not make a failing change look tested.
+class test_impact_store
+{
+public:
+    using stamps = std::flat_map<std::string, std::string, std::less<>>;
+
+    // One (unit key, test id) row per registered test. An empty key is a test whose file maps
+    // to no unit — a header, a vendored helper — which every selection keeps.
+    struct catalogue
+    {
+        std::string runner_stamp{};
+        std::vector<std::pair<std::string, std::string>> tests{};
+    };
+
+    explicit test_impact_store(std::string cache_dir)
+        : baseline_file_{cache_dir, baseline_filename},
+          catalogue_file_{cache_dir, catalogue_filename},
+          listing_file_{cache_dir, listing_filename},
+          selection_file_{std::move(cache_dir), selection_filename}
+    {}
+
+    // Where the runner's `--list --jsonl` output is captured, and where the selected ids are
+    // written for `--ids-from=`. Scratch files: rewritten by each use, kept for inspection.
+    const std::string& listing_path() const { return listing_file_.path(); }
+    const std::string& selection_path() const { return selection_file_.path(); }
+
+    std::optional<stamps> load_baseline() const
+    {
+        auto file = std::ifstream{baseline_file_.path()};
+        if(not file)
+            return std::nullopt;
+        auto loaded = stamps{};
+        auto unit = ""s;
+        auto stamp = ""s;
+        while(std::getline(file, unit, '\t') and std::getline(file, stamp))
+            loaded.insert_or_assign(unit, stamp);
+        return loaded;
+    }
+
+    void save_baseline(const stamps& units) const
+    {
+        baseline_file_.replace("test baseline", [&](std::ostream& file) {
+            for(const auto& [unit, stamp] : units)
+                file << unit << '\t' << stamp << '\n';
+        });
+    }
+
+    std::optional<catalogue> load_catalogue() const
+    {
+        auto file = std::ifstream{catalogue_file_.path()};
+        auto loaded = catalogue{};
+        if(not file or not std::getline(file, loaded.runner_stamp))
+            return std::nullopt;
+        auto unit = ""s;
+        auto id = ""s;
+        while(std::getline(file, unit, '\t') and std::getline(file, id))
+            loaded.tests.emplace_back(unit, id);
+        return loaded;
+    }
+
+    void save_catalogue(const catalogue& tests) const
+    {
+        catalogue_file_.replace("test catalogue", [&](std::ostream& file) {
+            file << tests.runner_stamp << '\n';
+            for(const auto& [unit, id] : tests.tests)
+                file << unit << '\t' << id << '\n';
+        });
+    }
+
+    // The id and file of every registered_test line in a `--list --jsonl` capture. Our own
+    // writer's output, so this finds two string fields rather than parsing JSON.
+    std::vector<std::pair<std::string, std::string>> read_listing() const
+    {
+        auto listed = std::vector<std::pair<std::string, std::string>>{};
+        auto file = std::ifstream{listing_file_.path()};
+        for(auto line = ""s; std::getline(file, line);)
+        {
+            if(not line.contains("\"type\":\"registered_test\""))
+                continue;
+            auto id = string_field(line, "id");
+            auto source = string_field(line, "file");
+            if(id and source)
+                listed.emplace_back(std::move(*id), std::move(*source));
+        }
+        return listed;
+    }
+
+    void write_selection(const std::flat_set<std::string, std::less<>>& ids) const
+    {
+        selection_file_.replace("affected test ids", [&](std::ostream& file) {
+            for(const auto& id : ids)
+                file << id << '\n';
+        });
+    }
+
+private:
+    static std::optional<std::string> string_field(std::string_view line, std::string_view key)
+    {
+        const auto quoted = "\""s + std::string{key} + "\":\"";
+        const auto start = line.find(quoted);
+        if(start == std::string_view::npos)
+            return std::nullopt;
+
+        auto value = ""s;
+        for(auto at = start + quoted.size(); at < line.size(); ++at)
+        {
+            if(line[at] == '"')
+                return value;
+            if(line[at] == '\\' and at + 1 < line.size())
+            {
+                const auto escaped = line[++at];
+                value.push_back(escaped == 'n' ? '\n' : escaped == 't' ? '\t' : escaped);
+            }
+            else
+                value.push_back(line[at]);
+        }
+        return std::nullopt;
+    }
+
+    inline static constexpr auto baseline_filename = "test-baseline.txt"sv;
+    inline static constexpr auto catalogue_filename = "test-catalogue.txt"sv;
+    inline static constexpr auto listing_filename = "test-catalogue.jsonl"sv;
+    inline static constexpr auto selection_filename = "test-affected-ids.txt"sv;
+
+    storage_file baseline_file_;
+    storage_file catalogue_file_;
+    storage_file listing_file_;
+    storage_file selection_file_;
+};
+
 // Std BMI/object freshness — no project artifact index or memo state. Safe to call while a
 // scan rebuilds scanned_project / analyzer on another thread.
 std::optional<output::rebuild_info> rebuild_reason_for_standard_module(
@@ -2988,12 +3449,15 @@ std::optional<output::rebuild_info> rebuild_reason_for_link(
 class analyzer
 {
 public:
+    // `digests` is null unless --freshness=digest; it must outlive the analyzer.
     analyzer(std::string source_root,
              std::string bmi_root,
-             const artifacts::index& unit_artifacts)
+             const artifacts::index& unit_artifacts,
+             const content_digest_store* digests = nullptr)
         : source_root_{detail::canonical_path(source_root)},
           bmi_root_{detail::canonical_path(bmi_root)},
-          unit_artifacts_{unit_artifacts}
+          unit_artifacts_{unit_artifacts},
+          digests_{digests}
     {}
 
     const artifacts::of_unit& artifacts_of(const source::translation_unit& tu) const
@@ -3031,6 +3495,16 @@ public:
         decisions_.erase(tu.unit());
     }
 
+    // A compile step of this build wrote the unit's BMI, and its importers are about to be
+    // released. From here its BMI is the answer for them: the unit's own decision still reads
+    // the object cache loaded before the build, and would call the source changed until the
+    // build ends — sending every importer after a rebuilt interface, whatever its BMI now holds.
+    void bmi_written(const source::translation_unit& tu) const
+    {
+        auto lock = std::lock_guard<std::mutex>{decisions_mutex_};
+        written_bmis_.insert(tu.unit());
+    }
+
 private:
     std::optional<output::rebuild_info> decide_rebuild(
         const source::translation_unit& tu,
@@ -3048,9 +3522,14 @@ private:
                 .kind = output::rebuild_kind::not_in_cache,
                 .trigger_path = tu.full_path};
         }
+        // Under --freshness=digest a touched source that digests the same was restamped before
+        // this ran, so a newer one here has a digest to say it changed — unless it never had one.
         if(loaded.entries().at(tu.full_path) < tu.last_modified)
             return output::rebuild_info{
-                .kind = output::rebuild_kind::source_stale,
+                .kind = digests_ != nullptr
+                        and digests_->source_digest(tu.full_path, loaded.entries().at(tu.full_path))
+                    ? output::rebuild_kind::source_changed
+                    : output::rebuild_kind::source_stale,
                 .trigger_path = tu.full_path};
 
         // A modular object-only repair reuses its BMI, so validate all BMI inputs before
@@ -3083,8 +3562,8 @@ private:
             const auto interface_bmi = detail::file_time(interface_art.bmi);
             if(not interface_bmi)
                 return bmi_rebuild(output::rebuild_kind::dependency_bmi_stale, interface, interface_art);
-            if(*interface_bmi > object_timestamp)
-                return bmi_rebuild(output::rebuild_kind::bmi_stale, interface, interface_art);
+            if(auto newer = imported_bmi_newer(interface, interface_art, *interface_bmi, object_timestamp))
+                return newer;
             if(auto interface_reason = rebuild_reason_for(interface, loaded, units))
                 return attributed_to(*interface_reason, interface);
         }
@@ -3128,6 +3607,10 @@ private:
                 const auto dependency_bmi = detail::file_time(dependency_art.bmi);
                 if(not dependency_bmi or *dependency_bmi < dependency.last_modified)
                     return bmi_rebuild(output::rebuild_kind::dependency_bmi_stale, dependency, dependency_art);
+                // Under --freshness=digest a BMI this build rewrote was weighed by content above,
+                // along with everything it imports; bytes that did not change are no reason.
+                if(digests_ != nullptr and bmi_written_this_build(dependency))
+                    continue;
             }
             if(auto dependency_reason = rebuild_reason_for(dependency, loaded, units))
                 return attributed_to(*dependency_reason, dependency);
@@ -3202,6 +3685,12 @@ private:
         return prerequisites;
     }
 
+    bool bmi_written_this_build(const source::translation_unit& tu) const
+    {
+        auto lock = std::lock_guard<std::mutex>{decisions_mutex_};
+        return written_bmis_.contains(tu.unit());
+    }
+
     static output::rebuild_info bmi_rebuild(output::rebuild_kind kind,
                                             const source::translation_unit& tu,
                                             const artifacts::of_unit& artifacts)
@@ -3222,6 +3711,28 @@ private:
         return reason;
     }
 
+    // An imported BMI written after this object was. Under --freshness=digest the time that
+    // counts is when its content last changed, so a provider recompiled into the same bytes
+    // leaves its importers alone; a BMI with no row for its current file falls back on mtime.
+    std::optional<output::rebuild_info> imported_bmi_newer(const source::translation_unit& provider,
+                                                           const artifacts::of_unit& provider_artifacts,
+                                                           fs::file_time_type bmi_timestamp,
+                                                           fs::file_time_type object_timestamp) const
+    {
+        if(digests_ != nullptr)
+        {
+            if(const auto changed = digests_->content_changed(provider_artifacts.bmi, bmi_timestamp))
+            {
+                if(*changed > object_timestamp)
+                    return bmi_rebuild(output::rebuild_kind::bmi_changed, provider, provider_artifacts);
+                return std::nullopt;
+            }
+        }
+        if(bmi_timestamp > object_timestamp)
+            return bmi_rebuild(output::rebuild_kind::bmi_stale, provider, provider_artifacts);
+        return std::nullopt;
+    }
+
     std::optional<output::rebuild_info> transitive_bmi_newer_than_object(
         const source::translation_unit& tu,
         fs::file_time_type object_timestamp,
@@ -3237,9 +3748,9 @@ private:
             if(dependency.is_modular)
             {
                 const auto& dependency_art = artifacts_of(dependency);
-                if(const auto dependency_bmi = detail::file_time(dependency_art.bmi);
-                   dependency_bmi and *dependency_bmi > object_timestamp)
-                    return bmi_rebuild(output::rebuild_kind::bmi_stale, dependency, dependency_art);
+                if(const auto dependency_bmi = detail::file_time(dependency_art.bmi))
+                    if(auto newer = imported_bmi_newer(dependency, dependency_art, *dependency_bmi, object_timestamp))
+                        return newer;
             }
 
             if(visited.contains(dependency.unit()))
@@ -3321,10 +3832,12 @@ private:
     std::string source_root_;
     std::string bmi_root_;
     const artifacts::index& unit_artifacts_;
+    const content_digest_store* digests_ = nullptr;
     // Decisions and resolved paths are shared by the compile workers; the analyzer itself
     // stays logically const, so both caches lock rather than serialize the callers.
     mutable std::mutex decisions_mutex_{};
     mutable std::flat_map<std::string_view, std::optional<output::rebuild_info>, std::less<>> decisions_{};
+    mutable std::flat_set<std::string_view, std::less<>> written_bmis_{};
     mutable std::mutex resolved_mutex_{};
     mutable std::deque<resolved_prerequisite_info> resolved_arena_{};
     mutable std::flat_map<std::string, std::size_t, std::less<>> resolved_index_{};
@@ -3876,6 +4389,9 @@ public:
         toolchain::linkage linkage{toolchain::linkage::dynamic};
         // Changing schemes rebuilds every modular unit.
         toolchain::module_compilation module_phases{toolchain::module_compilation::two_phase};
+        // Not a profile field: either basis reads the other's cache correctly, only more
+        // conservatively, so switching does not rebuild anything.
+        cache::freshness_basis freshness{cache::freshness_basis::mtime};
         string_list extra_compile_flags{};
         string_list extra_link_flags{};
 
@@ -3892,6 +4408,8 @@ private:
     scanned_project project_{};
     // Recreated after every scan; holds a reference into project_.artifacts.
     std::optional<cache::analyzer> analyzer_{};
+    // Present only under --freshness=digest; the analyzer points at it.
+    std::optional<cache::content_digest_store> content_digests_{};
     const build_config config;
     const build_tree::paths artifact_paths;
     bool include_tests = false;
@@ -4147,7 +4665,8 @@ private:
             source_dir, include_tests, include_examples, job_limit()}.scan();
         fill_project_artifacts();
         fill_project_indexes();
-        analyzer_.emplace(source_dir, artifact_paths.bmi.string(), project_.artifacts);
+        analyzer_.emplace(source_dir, artifact_paths.bmi.string(), project_.artifacts,
+                          content_digests_ ? &*content_digests_ : nullptr);
     }
 
     // Standard library module
@@ -4227,6 +4746,11 @@ private:
     // Edge-driven readiness: a unit job is claimable once every provider has published.
     // Two-phase modular rebuilds split after --precompile: publish, enqueue an object_followup
     // job, and let the worker claim an importer while pcm→.o runs on a later claim.
+    //
+    // Among claimable jobs the one with the longest weighted path to the end of the graph goes
+    // first. In first-come order a deep interface chain waits behind every cheap leaf that
+    // happened to be ready before it, and the build ends when the chain does; by remaining
+    // path, the leaves fill the workers the chain leaves idle instead.
     class compile_schedule
     {
     public:
@@ -4236,12 +4760,24 @@ private:
         {
             std::size_t index = 0;
             job_kind kind = job_kind::unit;
+            std::int64_t priority = 0;
+        };
+
+        // What a unit costs its importers and what it costs after them: `publish` until its
+        // dependents can start (the BMI under two-phase, the whole compile otherwise) and
+        // `tail` for the rest (the BMI → object step that runs beside the importers).
+        struct unit_cost
+        {
+            std::int64_t publish = 1;
+            std::int64_t tail = 0;
         };
 
-        explicit compile_schedule(const source::translation_unit_list& units)
+        compile_schedule(const source::translation_unit_list& units, std::span<const unit_cost> costs)
             : unit_count_{units.size()},
               dependents_(unit_count_),
               dependencies_remaining_(unit_count_),
+              remaining_path_(unit_count_),
+              tail_(unit_count_),
               published_(unit_count_)
         {
             auto keys = std::views::iota(std::size_t{0}, unit_count_)
@@ -4270,9 +4806,11 @@ private:
                 });
             }
 
+            weigh(costs);
+
             for(auto index = std::size_t{0}; index < unit_count_; ++index)
                 if(dependencies_remaining_[index] == 0)
-                    ready_.push({index, job_kind::unit});
+                    ready_.push({index, job_kind::unit, remaining_path_[index]});
             if(ready_.empty())
                 throw std::runtime_error{"No dependency-free translation unit"};
         }
@@ -4285,7 +4823,7 @@ private:
             });
             if(failures.failed() or completed_ == unit_count_)
                 return std::nullopt;
-            const auto next = ready_.front();
+            const auto next = ready_.top();
             ready_.pop();
             return next;
         }
@@ -4302,7 +4840,7 @@ private:
                 for(const auto dependent : dependents_[provider])
                 {
                     if(--dependencies_remaining_[dependent] == 0)
-                        ready_.push({dependent, job_kind::unit});
+                        ready_.push({dependent, job_kind::unit, remaining_path_[dependent]});
                 }
             }
             changed_.notify_all();
@@ -4312,7 +4850,7 @@ private:
         {
             {
                 auto lock = std::lock_guard<std::mutex>{mutex_};
-                ready_.push({index, job_kind::object_followup});
+                ready_.push({index, job_kind::object_followup, tail_[index]});
             }
             changed_.notify_all();
         }
@@ -4331,10 +4869,50 @@ private:
         std::size_t unit_count() const { return unit_count_; }
 
     private:
+        // Longest path first; equal paths keep scan order, so a graph with no recorded
+        // durations — every publish weighs 1 — schedules by depth and is still deterministic.
+        struct shorter_path
+        {
+            bool operator()(const job& left, const job& right) const
+            {
+                if(left.priority != right.priority)
+                    return left.priority < right.priority;
+                return left.index > right.index;
+            }
+        };
+
+        // Dependents before providers: a unit's path is its publish cost plus the longer of
+        // its own tail and the longest path among the units waiting on it.
+        void weigh(std::span<const unit_cost> costs)
+        {
+            auto waiting = dependencies_remaining_;
+            auto order = std::vector<std::size_t>{};
+            order.reserve(unit_count_);
+            for(auto index = std::size_t{0}; index < unit_count_; ++index)
+                if(waiting[index] == 0)
+                    order.push_back(index);
+            for(auto next = std::size_t{0}; next < order.size(); ++next)
+                for(const auto dependent : dependents_[order[next]])
+                    if(--waiting[dependent] == 0)
+                        order.push_back(dependent);
+
+            for(const auto index : order | std::views::reverse)
+            {
+                const auto cost = index < costs.size() ? costs[index] : unit_cost{};
+                auto after = cost.tail;
+                for(const auto dependent : dependents_[index])
+                    after = std::max(after, remaining_path_[dependent]);
+                remaining_path_[index] = cost.publish + after;
+                tail_[index] = cost.tail;
+            }
+        }
+
         std::size_t unit_count_ = 0;
         std::vector<std::vector<std::size_t>> dependents_{};
         std::vector<std::size_t> dependencies_remaining_{};
-        std::queue<job> ready_{};
+        std::vector<std::int64_t> remaining_path_{};
+        std::vector<std::int64_t> tail_{};
+        std::priority_queue<job, std::vector<job>, shorter_path> ready_{};
         std::vector<unsigned char> published_{};
         std::size_t completed_ = 0;
         std::mutex mutex_{};
@@ -4344,6 +4922,7 @@ private:
     void run_compile_steps(const source::translation_unit& tu,
                            output::compile_scope& compile,
                            toolchain::compile_portion portion,
+                           cache::compile_duration_store& durations,
                            std::invocable auto&& on_dependency_ready)
     {
         const auto& artifacts = project_.artifacts_of(tu);
@@ -4352,15 +4931,123 @@ private:
             tu, artifacts, project_.interfaces, portion,
             [&](string_list argv, toolchain::compile_step step)
             {
+                const auto digest_bmi = content_digests_ and step.writes_bmi;
+                const auto bmi_before = digest_bmi ? detail::file_time(artifacts.bmi) : std::nullopt;
+                const auto started = std::chrono::steady_clock::now();
                 process_runner.run_step(
                     compile,
                     std::move(argv),
                     build_tree::paths::compile_log(step.output == toolchain::compile_output::bmi ? unit.bmi : unit.object));
+                durations.remember(tu.unit(), step.output,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started));
+                // Before the importers are released: they decide against what this BMI holds now.
+                if(digest_bmi)
+                {
+                    content_digests_->remember_bmi(artifacts.bmi, bmi_before);
+                    freshness().bmi_written(tu);
+                }
                 if(step.dependencies_ready)
                     on_dependency_ready();
             });
     }
 
+    // Each unit's weight in the schedule, from the durations its last compile took. Under
+    // two-phase an interface publishes after its BMI and finishes its object beside the
+    // importers; every other unit publishes when its only step ends. A unit never compiled
+    // before weighs the mean of those that were — or 1 when none were, which makes the order
+    // depth-first by import graph alone.
+    std::vector<compile_schedule::unit_cost> compile_costs(const cache::compile_duration_store& durations,
+                                                           bool two_phase) const
+    {
+        auto recorded = project_.units
+            | std::views::transform([&](const source::translation_unit& tu) { return durations.remembered(tu.unit()); })
+            | std::ranges::to<std::vector>();
+
+        auto known = recorded | std::views::filter([](const auto& phases) { return phases.has_value(); });
+        const auto known_count = std::ranges::distance(known);
+        const auto known_total = std::ranges::fold_left(known, std::int64_t{0}, [](std::int64_t total, const auto& phases) {
+            return total + phases->bmi_ms + phases->object_ms;
+        });
+        const auto fallback = known_count > 0 ? std::max<std::int64_t>(1, known_total / known_count) : 1;
+
+        auto costs = std::vector<compile_schedule::unit_cost>{};
+        costs.reserve(project_.units.size());
+        for(auto index = std::size_t{0}; index < project_.units.size(); ++index)
+        {
+            if(not recorded[index])
+            {
+                costs.push_back({.publish = fallback});
+                continue;
+            }
+            const auto& phases = *recorded[index];
+            if(two_phase and project_.units[index].is_modular)
+                costs.push_back({.publish = std::max<std::int64_t>(1, phases.bmi_ms), .tail = phases.object_ms});
+            else
+                costs.push_back({.publish = std::max<std::int64_t>(1, phases.bmi_ms + phases.object_ms)});
+        }
+        return costs;
+    }
+
+    // --freshness=digest: a source newer than its object that digests as it did when that object
+    // was compiled is, for every freshness question, as old as that compile. Restamping the unit
+    // rather than teaching each check about digests keeps the own-BMI and importer comparisons
+    // exactly as they are. The digests read here are kept, so a real change is not read twice.
+    void cut_off_unchanged_sources(const cache::object_store& objects,
+                                   const cache::content_digest_store& digests,
+                                   std::span<std::optional<std::uint64_t>> current)
+    {
+        auto unchanged = 0;
+        for(auto index = std::size_t{0}; index < project_.units.size(); ++index)
+        {
+            auto& tu = project_.units[index];
+            const auto compiled = objects.remembered(tu.full_path);
+            if(not compiled or *compiled >= tu.last_modified)
+                continue;
+            const auto recorded = digests.source_digest(tu.full_path, *compiled);
+            if(not recorded)
+                continue;
+            current[index] = source::scanner::content_digest(tu.full_path);
+            if(current[index] != recorded)
+                continue;
+            tu.last_modified = *compiled;
+            ++unchanged;
+        }
+        if(unchanged > 0)
+            notify(&observer::info, "{} touched source(s) unchanged by content digest; not recompiled", unchanged);
+    }
+
+    // After a successful compile. A rebuilt unit keeps the digest read before its compile, so an
+    // edit racing that compile digests differently next time and recompiles. A unit fresh by mtime
+    // that was never digested gets one now — its object was compiled from the text on disk — so a
+    // later touch of it can be cut off too. Rows for units the tree no longer has are dropped.
+    void remember_content_digests(const cache::object_store& objects,
+                                  cache::content_digest_store& digests,
+                                  std::span<const unsigned char> rebuilt,
+                                  std::span<const std::optional<std::uint64_t>> source_digests)
+    {
+        auto current = std::flat_set<std::string, std::less<>>{};
+        for(auto index = std::size_t{0}; index < project_.units.size(); ++index)
+        {
+            const auto& tu = project_.units[index];
+            current.insert(tu.full_path);
+            if(tu.is_modular)
+            {
+                const auto& bmi = project_.artifacts_of(tu).bmi;
+                current.insert(bmi);
+                digests.seed_bmi(bmi);
+            }
+
+            // The time objects.record gives a rebuilt unit, so the row names that compile.
+            if(rebuilt[index] != 0)
+                digests.remember_source(tu.full_path, source_digests[index], tu.last_modified);
+            else if(objects.remembered(tu.full_path) == tu.last_modified
+                    and not digests.source_digest(tu.full_path, tu.last_modified))
+                digests.remember_source(tu.full_path, source::scanner::content_digest(tu.full_path), tu.last_modified);
+        }
+        digests.retain(current);
+        digests.save();
+    }
+
     void compile_units() {
         if (project_.units.empty()) return;
         auto objects = caches().make_object_store();
@@ -4371,13 +5058,23 @@ private:
             notify(&observer::profile_changed, output::rebuild_kind::profile_change,
                    *objects.profile_change());
 
-        auto schedule = compile_schedule{project_.units};
+        const auto two_phase = driver.module_phases_name() == "two-phase";
+        auto durations = caches().make_compile_duration_store();
+        durations.load();
+
+        auto source_digests = std::vector<std::optional<std::uint64_t>>(project_.units.size());
+        if(content_digests_)
+        {
+            content_digests_->load();
+            cut_off_unchanged_sources(objects, *content_digests_, source_digests);
+        }
+
+        auto schedule = compile_schedule{project_.units, compile_costs(durations, two_phase)};
         auto rebuilt = std::vector<unsigned char>(schedule.unit_count());
         // Open compile_start for a split two-phase unit until its object_followup finishes.
         auto pending = std::vector<std::unique_ptr<output::compile_scope>>(schedule.unit_count());
         auto failures = execution::failure_latch{};
         auto& freshness_of = freshness();
-        const auto two_phase = driver.module_phases_name() == "two-phase";
 
         execution::run_workers(
             execution::worker_count(job_limit(), schedule.unit_count()),
@@ -4393,7 +5090,7 @@ private:
                         {
                             auto compile = std::move(pending[index]);
                             run_compile_steps(
-                                tu, *compile, toolchain::compile_portion::object_followup, [] {});
+                                tu, *compile, toolchain::compile_portion::object_followup, durations, [] {});
                             compile->succeeded();
                             compile.reset();
                             freshness_of.artifacts_changed(tu);
@@ -4422,12 +5119,14 @@ private:
                             or reason->kind == output::rebuild_kind::object_stale;
                         const auto split = two_phase and tu.is_modular and not object_only;
                         const auto unit = output::compile_unit_of(tu, project_.artifacts_of(tu));
+                        if(content_digests_ and not source_digests[index])
+                            source_digests[index] = source::scanner::content_digest(tu.full_path);
 
                         if(split)
                         {
                             auto compile = std::make_unique<output::compile_scope>(unit, *reason);
                             run_compile_steps(
-                                tu, *compile, toolchain::compile_portion::bmi,
+                                tu, *compile, toolchain::compile_portion::bmi, durations,
                                 [&]() { schedule.publish(index, failures); });
                             // Park the open compile_scope before the followup is claimable.
                             pending[index] = std::move(compile);
@@ -4441,7 +5140,7 @@ private:
                             ? toolchain::compile_portion::object
                             : toolchain::compile_portion::all;
                         run_compile_steps(
-                            tu, compile, portion, [&]() { schedule.publish(index, failures); });
+                            tu, compile, portion, durations, [&]() { schedule.publish(index, failures); });
                         compile.succeeded();
                         freshness_of.artifacts_changed(tu);
                         rebuilt[index] = 1;
@@ -4464,7 +5163,11 @@ private:
                 const auto& tu = project_.units[index];
                 objects.record(tu.full_path, tu.last_modified);
             }
+        if(content_digests_)
+            remember_content_digests(objects, *content_digests_, rebuilt, source_digests);
         objects.save();
+        if(std::ranges::contains(rebuilt, 1))
+            durations.save();
     }
 
     // Linking
@@ -4592,6 +5295,176 @@ private:
         links.save();
     }
 
+    // Test impact (`test --affected`)
+
+    // Object stamps stand in for "did this unit change". The analyzer rewrites an object when its
+    // source, a header it includes, or a BMI it imports moved, so a stamp equal to the one the
+    // last passing run saw means nothing that unit's tests could observe has changed since.
+    static std::string stamp_of(const std::string& path)
+    {
+        const auto stamp = detail::file_time(path);
+        if(not stamp)
+            return "missing";
+        return std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(stamp->time_since_epoch()).count());
+    }
+
+    cache::test_impact_store::stamps object_stamps() const
+    {
+        auto current = cache::test_impact_store::stamps{};
+        for(const auto& tu : project_.units)
+            current.insert_or_assign(std::string{tu.unit()}, stamp_of(project_.artifacts_of(tu).object));
+        return current;
+    }
+
+    // The runner's catalogue with each test attributed to the unit that registered it. Listed
+    // again only when the runner was relinked — its stamp heads the cached file — so an
+    // unchanged runner costs one read rather than a process. A test whose file is none of ours
+    // (a header, a helper outside the scan) keeps an empty key and is always selected.
+    std::optional<cache::test_impact_store::catalogue> test_catalogue(
+        const cache::test_impact_store& impact, const std::string& runner) const
+    {
+        const auto runner_stamp = stamp_of(runner);
+        if(auto cached = impact.load_catalogue(); cached and cached->runner_stamp == runner_stamp)
+            return cached;
+
+        const auto argv = string_list{runner, "--list", "--jsonl=summary"};
+        if(not process_runner.invoke_shell(argv, impact.listing_path()).ok())
+            return std::nullopt;
+
+        // source_location reports the path the compiler was given, which is full_path; the
+        // file name alone is the fallback for a runner built elsewhere, when it is unambiguous.
+        auto unit_of_path = std::flat_map<std::string, std::string_view, std::less<>>{};
+        auto unit_of_name = std::flat_map<std::string_view, std::string_view, std::less<>>{};
+        auto ambiguous = std::flat_set<std::string_view, std::less<>>{};
+        for(const auto& tu : project_.units)
+        {
+            unit_of_path.insert_or_assign(fs::path{tu.full_path}.lexically_normal().string(), tu.unit());
+            if(not unit_of_name.emplace(tu.filename, tu.unit()).second)
+                ambiguous.insert(tu.filename);
+        }
+
+        auto listed = cache::test_impact_store::catalogue{.runner_stamp = runner_stamp};
+        for(auto& [id, file] : impact.read_listing())
+        {
+            const auto source = fs::path{file}.lexically_normal();
+            const auto name = source.filename().string();
+            auto unit = std::string{};
+            if(const auto found = unit_of_path.find(source.string()); found != unit_of_path.end())
+                unit = found->second;
+            else if(const auto named = unit_of_name.find(name); named != unit_of_name.end() and not ambiguous.contains(name))
+                unit = named->second;
+            listed.tests.emplace_back(std::move(unit), std::move(id));
+        }
+        impact.save_catalogue(listed);
+        return listed;
+    }
+
+    struct affected_tests
+    {
+        string_list changed_units{};
+        std::string fallback{}; // why the whole suite runs; empty when `ids` is the selection
+        std::flat_set<std::string, std::less<>> ids{};
+        std::size_t total = 0;
+    };
+
+    // Changed units are those whose object stamp differs from the baseline; affected units are
+    // those plus everything that imports them, transitively; the selection is every test an
+    // affected unit registered. Anything the import graph cannot scope — a plain translation
+    // unit reachable only through headers, the runner's own main — runs the whole suite rather
+    // than guess.
+    affected_tests select_affected_tests(const cache::test_impact_store& impact, const std::string& runner) const
+    {
+        auto selection = affected_tests{};
+        const auto baseline = impact.load_baseline();
+        if(not baseline)
+        {
+            selection.fallback = "no passing run recorded yet";
+            return selection;
+        }
+        const auto catalogue = test_catalogue(impact, runner);
+        if(not catalogue)
+        {
+            selection.fallback = "could not list the test runner's catalogue";
+            return selection;
+        }
+        selection.total = catalogue->tests.size();
+
+        const auto& units = project_.units;
+        const auto index_of = [&](std::string_view key) -> std::optional<std::size_t>
+        {
+            const auto found = project_.by_unit.find(key);
+            if(found == project_.by_unit.end())
+                return std::nullopt;
+            return static_cast<std::size_t>(&found->second.get() - units.data());
+        };
+
+        // The scheduler's edges reversed: who has to be tested again when a unit changes.
+        auto dependents = std::vector<std::vector<std::size_t>>(units.size());
+        for(auto index = std::size_t{0}; index < units.size(); ++index)
+        {
+            source::scanner::for_each_provider(units[index], index_of, [&](std::size_t provider)
+            {
+                dependents[provider].push_back(index);
+            });
+        }
+
+        auto affected = std::vector<bool>(units.size());
+        auto pending = std::vector<std::size_t>{};
+        const auto reach = [&](std::size_t index)
+        {
+            if(affected[index])
+                return;
+            affected[index] = true;
+            pending.push_back(index);
+        };
+
+        const auto& runner_unit = test_runner_unit();
+        for(auto index = std::size_t{0}; index < units.size(); ++index)
+        {
+            const auto& tu = units[index];
+            const auto previous = baseline->find(tu.unit());
+            if(previous != baseline->end() and previous->second == stamp_of(project_.artifacts_of(tu).object))
+                continue;
+            // Other mains are not linked into the runner: no test can observe them.
+            if(tu.has_main and &tu != &runner_unit)
+                continue;
+
+            selection.changed_units.emplace_back(tu.unit());
+            if(&tu == &runner_unit)
+                selection.fallback = "the test runner itself changed";
+            else if(tu.kind == source::unit_kind::non_module or tu.kind == source::unit_kind::global_fragment)
+            {
+                if(not tu.is_test)
+                    selection.fallback = tu.display_path + " is not a module unit, so no import names the tests that reach it";
+            }
+
+            reach(index);
+            // An implementation unit changes what its module's importers run, not only itself.
+            if(tu.kind == source::unit_kind::implementation_unit)
+                if(const auto interface = index_of(tu.module))
+                    reach(*interface);
+        }
+        if(not selection.fallback.empty())
+            return selection;
+
+        while(not pending.empty())
+        {
+            const auto index = pending.back();
+            pending.pop_back();
+            for(const auto dependent : dependents[index])
+                reach(dependent);
+        }
+
+        auto affected_units = std::flat_set<std::string_view, std::less<>>{};
+        for(auto index = std::size_t{0}; index < units.size(); ++index)
+            if(affected[index])
+                affected_units.insert(units[index].unit());
+        for(const auto& [unit, id] : catalogue->tests)
+            if(unit.empty() or affected_units.contains(unit))
+                selection.ids.insert(id);
+        return selection;
+    }
+
     // Build orchestration
 
     void build_steps()
@@ -4667,6 +5540,8 @@ public:
               (artifact_paths.cache / "command-probe.txt").string(),
               process_runner)}
     {
+        if(values.freshness == cache::freshness_basis::digest)
+            content_digests_.emplace(artifact_paths.cache.string());
         report_toolchain_configuration();
     }
 
@@ -4721,6 +5596,11 @@ public:
                  .module_flags = state.modules}};
         }
 
+        cache::compile_duration_store make_compile_duration_store() const
+        {
+            return cache::compile_duration_store{paths_.cache.string()};
+        }
+
         cache::standard_module_store make_standard_module_store() const
         {
             return cache::standard_module_store{
@@ -4906,8 +5786,17 @@ public:
         notify(&observer::success, "Build completed: {}", artifact_paths.root.string());
     }
 
+    // How much of the suite a run covers. `affected` narrows it to what changed since the last
+    // passing run; `narrowed` says the arguments already narrow it (a filter, --tags=, --shard=),
+    // so a pass says nothing about the rest of the suite and must not become the baseline.
+    struct test_scope_request
+    {
+        bool affected = false;
+        bool narrowed = false;
+    };
+
     // Returns false when the test runner reports failures (normal outcome, not exceptional).
-    bool run_tests(string_span args = {}) {
+    bool run_tests(string_span args = {}, test_scope_request request = {}) {
         notify(&observer::info, "=== Running tests ===");
 
         include_tests = true;
@@ -4924,6 +5813,30 @@ public:
         // From the unit link_test_runner just linked, so what runs is what was linked.
         const auto& runner = project_.artifacts_of(test_runner_unit()).executable;
 
+        const auto impact = cache::test_impact_store{artifact_paths.cache.string()};
+        auto runner_args = string_list{args.begin(), args.end()};
+        if(request.affected)
+        {
+            const auto selection = select_affected_tests(impact, runner);
+            notify(&observer::test_selection, output::test_selection{
+                .changed_units = selection.changed_units,
+                .fallback = selection.fallback,
+                .selected = selection.fallback.empty() ? selection.ids.size() : selection.total,
+                .total = selection.total});
+            if(selection.fallback.empty())
+            {
+                // Nothing reached a test: the last passing run still speaks for every one of them.
+                if(selection.ids.empty())
+                {
+                    if(not request.narrowed)
+                        impact.save_baseline(object_stamps());
+                    return true;
+                }
+                impact.write_selection(selection.ids);
+                runner_args.push_back("--ids-from=" + impact.selection_path());
+            }
+        }
+
         const auto set_env = [](std::string_view key, std::string_view value)
         {
             if(::setenv(std::string{key}.c_str(), std::string{value}.c_str(), /*overwrite=*/1) != 0)
@@ -4937,9 +5850,13 @@ public:
         {
             auto test = output::test_scope{runner};
             // Not captured: the runner's stdout is the JSONL stream being forwarded.
-            result = process_runner.invoke_shell(test_runner_argv(runner, args));
+            result = process_runner.invoke_shell(test_runner_argv(runner, runner_args));
             test.finished(result);
         }
+        // Only a pass moves the baseline: after a failure the same changes stay affected until
+        // a run covering them passes.
+        if(result.ok() and not request.narrowed)
+            impact.save_baseline(object_stamps());
         return result.ok();
     }
 
@@ -5057,6 +5974,7 @@ public:
     std::string std_module_source{};
     build_system::build_config config = build_system::build_config::debug;
     toolchain::module_compilation module_phases = toolchain::module_compilation::two_phase;
+    cache::freshness_basis freshness = cache::freshness_basis::mtime;
     bool do_clean = false;
     bool do_list = false;
     bool do_build = false;
@@ -5064,6 +5982,7 @@ public:
     bool do_cache_status = false;
     bool do_cache_invalidate = false;
     bool clean_tests_only = false;
+    bool affected_tests = false;
     toolchain::linkage linkage = toolchain::linkage::dynamic;
     bool include_examples = false;
     bool build_tests = false;
@@ -5076,6 +5995,7 @@ public:
     string_list extra_link_flags{};
     std::string output_name = "console";
     std::optional<output::jsonl::jsonl_mode> jsonl_mode{};
+    std::string trace_path{};
 
     build_system::settings build_settings() const
     {
@@ -5089,6 +6009,7 @@ public:
             .include_paths = include_paths,
             .linkage = linkage,
             .module_phases = module_phases,
+            .freshness = freshness,
             .extra_compile_flags = extra_compile_flags,
             .extra_link_flags = extra_link_flags,
             .max_jobs = max_jobs};
@@ -5105,9 +6026,22 @@ public:
     {
         if(clean_tests_only and not do_clean)
             return "--tests requires clean"s;
+        if(affected_tests and not do_run_tests)
+            return "--affected requires test"s;
         return std::nullopt;
     }
 
+    // Whether the runner arguments already run less than the whole suite. A pass under any of
+    // these proves nothing about the tests it skipped, so it must not become the baseline
+    // `--affected` compares against — and --list runs nothing at all.
+    bool narrows_test_run() const
+    {
+        return not test_filter.empty()
+            or std::ranges::any_of(test_runner_args, [](std::string_view arg) {
+                   return arg == "--list" or arg.starts_with("--tags=") or arg.starts_with("--shard=");
+               });
+    }
+
     // Resynthesize CB-owned flags the runner also understands. Parse consumes --jsonl / --jobs=
     // as CB actions, so they never appear in test_runner_args — emit them here when set.
     std::vector<std::string> runner_arguments() const
@@ -5275,6 +6209,9 @@ public:
                 case token_action::set_clean_tests_only:
                     parsed.clean_tests_only = true;
                     continue;
+                case token_action::set_affected:
+                    parsed.affected_tests = true;
+                    continue;
                 case token_action::set_jobs:
                 {
                     const auto text = argument.substr("--jobs="sv.size());
@@ -5299,6 +6236,18 @@ public:
                                     "--modules expects one-phase or two-phase, got: "s + std::string{text});
                     continue;
                 }
+                case token_action::set_freshness:
+                {
+                    const auto text = argument.substr("--freshness="sv.size());
+                    if(text == "mtime")
+                        parsed.freshness = cache::freshness_basis::mtime;
+                    else if(text == "digest")
+                        parsed.freshness = cache::freshness_basis::digest;
+                    else
+                        return fail(parse_error_kind::invalid_argument,
+                                    "--freshness expects mtime or digest, got: "s + std::string{text});
+                    continue;
+                }
                 case token_action::set_jsonl:
                 {
                     const auto mode = argument == "--jsonl"
@@ -5315,6 +6264,14 @@ public:
                     parsed.output_name = "jsonl";
                     continue;
                 }
+                case token_action::set_trace:
+                {
+                    const auto path = argument.substr("--trace="sv.size());
+                    if(path.empty())
+                        return fail(parse_error_kind::usage, "Missing path after --trace=");
+                    parsed.trace_path = std::string{path};
+                    continue;
+                }
                 case token_action::take_include:
                     if(arguments.empty())
                         return fail(parse_error_kind::usage, "Missing path after -I/--include");
@@ -5369,16 +6326,22 @@ public:
             << "  test [filter]  Build and run tests (optional substring filter)\n"
             << "                 Forward test_runner flags (e.g. --tags=, --list, --result);\n"
             << "                 --jsonl / --jobs= apply to CB and are passed on to the runner\n"
+            << "  test --affected  Run only tests whose units changed since the last passing run,\n"
+            << "                 or that import one that did (the whole suite when none passed yet)\n"
             << "  static           Enable static linking (C++ stdlib static)\n"
             << "  --include-examples Include examples directory in build (excluded by default)\n"
             << "  --build-tests    Build tests in release mode (useful for CI to verify compilation)\n"
             << "  --jsonl[=<summary|failures|trace>]  Machine-readable output (default: failures)\n"
             << "  --junit=<path>   Also write a JUnit/xUnit XML report (additive with --jsonl)\n"
+            << "  --trace=<path>   Also write every compile/link step as a Chrome trace (chrome://tracing)\n"
             << "  --jobs=N         Cap concurrent compile/link; also forward to test_runner\n"
             << "                   (compile default: CPU count; test_runner default: 1)\n"
             << "  --modules=<two-phase|one-phase>  How modular units compile (default: two-phase)\n"
             << "                   two-phase: --precompile to BMI, then BMI to object\n"
             << "                   one-phase: one -c -fmodule-output= step for both\n"
+            << "  --freshness=<mtime|digest>  What decides a unit is stale (default: mtime)\n"
+            << "                   digest: skip touched sources whose text minus comments is\n"
+            << "                   unchanged, and importers of a BMI rebuilt to the same bytes\n"
             << "  -I, --include    Add include directory (can be specified multiple times)\n"
             << "  --link-flags     Add extra linker flags (e.g., --link-flags \"-lcrypto\")\n"
             << "  --compile-flags  Add extra compiler flags\n"
@@ -5394,9 +6357,11 @@ public:
             << "  " << program << " ci\n"
             << "  " << program << " test\n"
             << "  " << program << " test --tags=[module]\n"
+            << "  " << program << " test --affected\n"
             << "  " << program << " test --jsonl=failures --tags=[module]\n"
             << "  " << program << " test --jsonl=failures --junit=report.xml --tags=[module]\n"
             << "  " << program << " debug build --jsonl=summary\n"
+            << "  " << program << " clean debug build --trace=build.json\n"
             << "  " << program << " test --jsonl=trace --slowest=10\n"
             << "  " << program << " clean\n";
     }
@@ -5424,9 +6389,12 @@ private:
         set_include_examples,
         set_build_tests,
         set_clean_tests_only,
+        set_affected,
         set_jobs,
         set_modules,
+        set_freshness,
         set_jsonl,
+        set_trace,
         take_include,
         take_link_flags,
         take_compile_flags,
@@ -5463,6 +6431,7 @@ private:
         {"--include-examples", false, token_owner::cb, token_action::set_include_examples},
         {"--build-tests", false, token_owner::cb, token_action::set_build_tests},
         {"--tests", false, token_owner::cb, token_action::set_clean_tests_only},
+        {"--affected", false, token_owner::cb, token_action::set_affected},
         {"-I", false, token_owner::cb, token_action::take_include},
         {"--include", false, token_owner::cb, token_action::take_include},
         {"--link-flags", false, token_owner::cb, token_action::take_link_flags},
@@ -5471,16 +6440,27 @@ private:
         {"--extra-compile-flags", false, token_owner::cb, token_action::take_compile_flags},
         {"--extra-compile-flags=", true, token_owner::cb, token_action::compile_flags_eq},
         {"--modules=", true, token_owner::cb, token_action::set_modules},
+        {"--freshness=", true, token_owner::cb, token_action::set_freshness},
         {"--jsonl-output-max-bytes=", true, token_owner::test_runner, token_action::classify_only},
+        {"--jsonl-flush=", true, token_owner::test_runner, token_action::classify_only},
         {"--list", false, token_owner::test_runner, token_action::classify_only},
         {"--result", false, token_owner::test_runner, token_action::classify_only},
         {"--tags=", true, token_owner::test_runner, token_action::classify_only},
         {"--slowest=", true, token_owner::test_runner, token_action::classify_only},
+        {"--resources", false, token_owner::test_runner, token_action::classify_only},
+        {"--heaviest=", true, token_owner::test_runner, token_action::classify_only},
+        {"--most-allocating=", true, token_owner::test_runner, token_action::classify_only},
+        {"--durations=", true, token_owner::test_runner, token_action::classify_only},
+        {"--shard=", true, token_owner::test_runner, token_action::classify_only},
+        {"--processes=", true, token_owner::test_runner, token_action::classify_only},
+        {"--bench-baseline=", true, token_owner::test_runner, token_action::classify_only},
+        {"--bench-threshold=", true, token_owner::test_runner, token_action::classify_only},
         {"--junit=", true, token_owner::test_runner, token_action::classify_only},
         {"--xunit-xml=", true, token_owner::test_runner, token_action::classify_only},
         {"--jsonl", false, token_owner::cb, token_action::set_jsonl},
         {"--jsonl=", true, token_owner::cb, token_action::set_jsonl},
         {"--jobs=", true, token_owner::cb, token_action::set_jobs},
+        {"--trace=", true, token_owner::cb, token_action::set_trace},
     };
 
     static bool token_matches(std::string_view arg, const known_token& token)
@@ -5528,6 +6508,7 @@ int main(int argc, char* argv[])
 
     auto console_observer = cb::output::console::observer{std::cerr};
     auto jsonl_observer = cb::output::jsonl::observer{std::cout};
+    auto trace_observer = cb::output::trace::observer{};
     cb::output::register_observer("console", console_observer);
     cb::output::register_observer("jsonl", jsonl_observer);
 
@@ -5574,6 +6555,12 @@ int main(int argc, char* argv[])
             notify(&observer::error, *problem);
             return 2;
         }
+        // Beside the selected observer, not instead of it: a traced build still reports.
+        if(not opts.trace_path.empty())
+        {
+            trace_observer.configure(opts.trace_path);
+            cb::output::observe(trace_observer);
+        }
 
         auto build_system = cb::build_system{opts.build_settings()};
 
@@ -5601,7 +6588,9 @@ int main(int argc, char* argv[])
             build_system.build();
         if(opts.do_run_tests)
         {
-            if(not build_system.run_tests(opts.runner_arguments()))
+            if(not build_system.run_tests(opts.runner_arguments(),
+                                          {.affected = opts.affected_tests,
+                                           .narrowed = opts.narrows_test_run()}))
                 return 1;
         }
         if(not opts.has_action())